@@ -1,4 +1,5 @@
 TEMPLATE = app
+QT += network
 TARGET =
 VERSION = 0.6.0
 INCLUDEPATH += src src/json src/qt ../libcoin/include
@@ -47,6 +48,13 @@ contains(USE_DBUS, 1) {
     QT += dbus
 }
 
+# use: qmake "USE_PEER_STATS=1"
+# requires per-peer statistics in libcoin: Node::getPeerInfo() and Node::disconnectPeer()
+contains(USE_PEER_STATS, 1) {
+    message(Building with per-peer statistics)
+    DEFINES += USE_PEER_STATS
+}
+
 # use: qmake "FIRST_CLASS_MESSAGING=1"
 contains(FIRST_CLASS_MESSAGING, 1) {
     message(Building with first-class messaging)
@@ -92,6 +100,27 @@ HEADERS += src/qt/bitcoingui.h \
     src/qt/transactionfilterproxy.h \
     src/qt/transactionview.h \
     src/qt/walletmodel.h \
+    src/qt/walletbalance.h \
+    src/qt/walletmanager.h \
+    src/qt/walletrescanner.h \
+    src/qt/keypoolrefiller.h \
+    src/qt/deterministickeychain.h \
+    src/qt/rescandialog.h \
+    src/qt/startupprofiler.h \
+    src/qt/batchclient.h \
+    src/qt/synctablemodel.h \
+    src/qt/syncdiagnosticsdialog.h \
+    src/qt/peertablemodel.h \
+    src/qt/peersdialog.h \
+    src/qt/memoryusage.h \
+    src/qt/memorydialog.h \
+    src/qt/memoryrpc.h \
+    src/qt/walletinterface.h \
+    src/qt/addresschecker.h \
+    src/qt/addressbookfile.h \
+    src/qt/messagesigner.h \
+    src/qt/messagerpc.h \
+    src/qt/addressfilterproxy.h \
     src/qt/overviewpage.h \
     src/qt/csvmodelwriter.h \
     src/qt/bitcoinamountfield.h \
@@ -125,6 +154,27 @@ SOURCES += src/qt/bitcoin.cpp src/qt/bitcoingui.cpp \
     src/qt/transactionfilterproxy.cpp \
     src/qt/transactionview.cpp \
     src/qt/walletmodel.cpp \
+    src/qt/walletbalance.cpp \
+    src/qt/walletmanager.cpp \
+    src/qt/walletrescanner.cpp \
+    src/qt/keypoolrefiller.cpp \
+    src/qt/deterministickeychain.cpp \
+    src/qt/rescandialog.cpp \
+    src/qt/startupprofiler.cpp \
+    src/qt/batchclient.cpp \
+    src/qt/synctablemodel.cpp \
+    src/qt/syncdiagnosticsdialog.cpp \
+    src/qt/peertablemodel.cpp \
+    src/qt/peersdialog.cpp \
+    src/qt/memoryusage.cpp \
+    src/qt/memorydialog.cpp \
+    src/qt/memoryrpc.cpp \
+    src/qt/walletinterface.cpp \
+    src/qt/addresschecker.cpp \
+    src/qt/addressbookfile.cpp \
+    src/qt/messagesigner.cpp \
+    src/qt/messagerpc.cpp \
+    src/qt/addressfilterproxy.cpp \
     src/qt/overviewpage.cpp \
     src/qt/csvmodelwriter.cpp \
     src/qt/sendcoinsentry.cpp \
@@ -147,7 +197,11 @@ FORMS += \
     src/qt/forms/transactiondescdialog.ui \
     src/qt/forms/overviewpage.ui \
     src/qt/forms/sendcoinsentry.ui \
-    src/qt/forms/askpassphrasedialog.ui
+    src/qt/forms/askpassphrasedialog.ui \
+    src/qt/forms/rescandialog.ui \
+    src/qt/forms/syncdiagnosticsdialog.ui \
+    src/qt/forms/peersdialog.ui \
+    src/qt/forms/memorydialog.ui
 
 contains(USE_QRCODE, 1) {
 HEADERS += src/qt/qrcodedialog.h
@@ -157,14 +211,53 @@ FORMS += src/qt/forms/qrcodedialog.ui
 
 contains(BITCOIN_QT_TEST, 1) {
 SOURCES += src/qt/test/test_main.cpp \
-    src/qt/test/urltests.cpp
-HEADERS += src/qt/test/urltests.h
-DEPENDPATH += src/qt/test
+    src/qt/test/urltests.cpp \
+    src/qt/test/bitcoinunitstests.cpp \
+    src/qt/test/addresscheckertests.cpp \
+    src/qt/test/addressbookfiletests.cpp \
+    src/qt/test/guiutiltests.cpp \
+    src/qt/test/messagesignertests.cpp \
+    src/qt/test/walletbalancetests.cpp \
+    src/qt/test/startupprofilertests.cpp \
+    src/qt/test/batchclienttests.cpp \
+    src/qt/test/synctablemodeltests.cpp \
+    src/qt/test/addresstablemodeltests.cpp \
+    src/qt/bench/syntheticwallet.cpp
+HEADERS += src/qt/test/urltests.h \
+    src/qt/test/bitcoinunitstests.h \
+    src/qt/test/addresscheckertests.h \
+    src/qt/test/addressbookfiletests.h \
+    src/qt/test/guiutiltests.h \
+    src/qt/test/messagesignertests.h \
+    src/qt/test/walletbalancetests.h \
+    src/qt/test/startupprofilertests.h \
+    src/qt/test/batchclienttests.h \
+    src/qt/test/synctablemodeltests.h \
+    src/qt/test/addresstablemodeltests.h \
+    src/qt/bench/syntheticwallet.h
+DEPENDPATH += src/qt/test src/qt/bench
 QT += testlib
 TARGET = bitcoin-qt_test
 DEFINES += BITCOIN_QT_TEST
 }
 
+# use: qmake "BITCOIN_QT_BENCH=1"
+contains(BITCOIN_QT_BENCH, 1) {
+SOURCES += src/qt/bench/bench_main.cpp \
+    src/qt/bench/benchmark.cpp \
+    src/qt/bench/modelbench.cpp \
+    src/qt/bench/syntheticwallet.cpp \
+    src/qt/bench/uibench.cpp
+HEADERS += src/qt/bench/benchmark.h \
+    src/qt/bench/modelbench.h \
+    src/qt/bench/syntheticwallet.h \
+    src/qt/bench/uibench.h
+DEPENDPATH += src/qt/bench
+QT += testlib
+TARGET = bitcoin-qt_bench
+DEFINES += BITCOIN_QT_BENCH
+}
+
 CODECFORTR = UTF-8
 
 # for lrelease/lupdate
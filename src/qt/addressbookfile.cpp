@@ -0,0 +1,179 @@
+#include "addressbookfile.h"
+#include "guiutil.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegExp>
+
+#include <coinHTTP/RPC.h>
+
+typedef WalletInterface::AddressBookEntry Entry;
+
+AddressBookFile::Format AddressBookFile::formatForFile(const QString &filename)
+{
+    return QFileInfo(filename).suffix().compare("json", Qt::CaseInsensitive) == 0 ? JSON : CSV;
+}
+
+bool AddressBookFile::read(const QString &filename, QList<Entry> &entries, QString &error)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = file.errorString();
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    QString data = in.readAll();
+
+    switch(formatForFile(filename))
+    {
+    case JSON:
+        return parseJSON(data, entries, error);
+    case CSV:
+        break;
+    }
+    return parseCSV(data, entries, error);
+}
+
+bool AddressBookFile::write(const QString &filename, const QList<Entry> &entries)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    switch(formatForFile(filename))
+    {
+    case JSON:
+        out << toJSON(entries);
+        break;
+    case CSV:
+        out << toCSV(entries);
+        break;
+    }
+    out.flush();
+    file.close();
+
+    return file.error() == QFile::NoError;
+}
+
+bool AddressBookFile::parseCSV(const QString &data, QList<Entry> &entries, QString &error)
+{
+    QList<QStringList> records;
+    QList<int> lines;
+    if(!GUIUtil::parseCSV(data, records, &lines))
+    {
+        error = QObject::tr("Unterminated quoted field on line %1").arg(lines.last());
+        return false;
+    }
+
+    // Columns are labeled by the header row if there is one, as in our own export
+    int labelColumn = 0, addressColumn = 1;
+    int first = 0;
+    if(!records.isEmpty())
+    {
+        const QStringList &header = records.at(0);
+        int l = header.indexOf(QRegExp("label", Qt::CaseInsensitive));
+        int a = header.indexOf(QRegExp("address", Qt::CaseInsensitive));
+        if(a >= 0)
+        {
+            labelColumn = l;
+            addressColumn = a;
+            first = 1;
+        }
+        else if(header.size() == 1)
+        {
+            // Plain list of addresses
+            labelColumn = -1;
+            addressColumn = 0;
+        }
+    }
+
+    entries.reserve(entries.size() + records.size() - first);
+    for(int i = first; i < records.size(); ++i)
+    {
+        const QStringList &record = records.at(i);
+        if(addressColumn >= record.size())
+        {
+            error = QObject::tr("Missing address on line %1").arg(lines.at(i));
+            return false;
+        }
+        QString label = (labelColumn >= 0 && labelColumn < record.size()) ? record.at(labelColumn) : QString();
+        entries.append(Entry(record.at(addressColumn), label, false));
+    }
+    return true;
+}
+
+bool AddressBookFile::parseJSON(const QString &data, QList<Entry> &entries, QString &error)
+{
+    using namespace json_spirit;
+    Value value;
+    if(!json_spirit::read(std::string(data.toUtf8().constData()), value) || value.type() != array_type)
+    {
+        error = QObject::tr("Expected a JSON array of address book entries");
+        return false;
+    }
+    const Array &array = value.get_array();
+    entries.reserve(entries.size() + (int)array.size());
+    for(Array::size_type i = 0; i < array.size(); ++i)
+    {
+        const Value &item = array[i];
+        if(item.type() != obj_type)
+        {
+            error = QObject::tr("Entry %1 is not an object").arg(i + 1);
+            return false;
+        }
+        const Value &address = find_value(item.get_obj(), "address");
+        const Value &label = find_value(item.get_obj(), "label");
+        if(address.type() != str_type || (label.type() != str_type && label.type() != null_type))
+        {
+            error = QObject::tr("Entry %1 has no address").arg(i + 1);
+            return false;
+        }
+        entries.append(Entry(QString::fromUtf8(address.get_str().c_str()),
+                             label.type() == str_type ? QString::fromUtf8(label.get_str().c_str()) : QString(),
+                             false));
+    }
+    return true;
+}
+
+static QString quoteCSV(const QString &value)
+{
+    QString quoted = value;
+    quoted.replace('"', "\"\"");
+    return "\"" + quoted + "\"";
+}
+
+QString AddressBookFile::toCSV(const QList<Entry> &entries)
+{
+    QString data;
+    // Header, fields and line break of roughly 60 characters per entry
+    data.reserve(20 + entries.size() * 64);
+    data.append("\"Label\",\"Address\"\n");
+    foreach(const Entry &entry, entries)
+    {
+        data.append(quoteCSV(entry.label));
+        data.append(',');
+        data.append(quoteCSV(entry.address));
+        data.append('\n');
+    }
+    return data;
+}
+
+QString AddressBookFile::toJSON(const QList<Entry> &entries)
+{
+    using namespace json_spirit;
+    Array array;
+    array.reserve(entries.size());
+    foreach(const Entry &entry, entries)
+    {
+        Object item;
+        item.push_back(Pair("label", std::string(entry.label.toUtf8().constData())));
+        item.push_back(Pair("address", std::string(entry.address.toUtf8().constData())));
+        array.push_back(item);
+    }
+    return QString::fromUtf8(write_formatted(array).c_str()) + "\n";
+}
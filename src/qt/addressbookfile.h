@@ -0,0 +1,43 @@
+#ifndef ADDRESSBOOKFILE_H
+#define ADDRESSBOOKFILE_H
+
+#include <QString>
+#include <QList>
+
+#include "walletinterface.h"
+
+/** Read and write address book entries in bulk, as CSV in the format of the address book export
+    ("Label","Address" with a header row) or as a JSON array of {"label": ..., "address": ...} objects.
+    The format is chosen by file extension, anything that is not .json is read as CSV.
+ */
+class AddressBookFile
+{
+public:
+    enum Format
+    {
+        CSV,
+        JSON
+    };
+
+    static Format formatForFile(const QString &filename);
+
+    /** Read entries from a file. Entries are returned as found, without any validation of the
+        addresses. Returns false and sets error if the file could not be read or parsed.
+     */
+    static bool read(const QString &filename, QList<WalletInterface::AddressBookEntry> &entries, QString &error);
+    /** Write entries to a file, returns false if it could not be written */
+    static bool write(const QString &filename, const QList<WalletInterface::AddressBookEntry> &entries);
+
+    /** @name Parsing and formatting of file contents
+        @{*/
+    static bool parseCSV(const QString &data, QList<WalletInterface::AddressBookEntry> &entries, QString &error);
+    static bool parseJSON(const QString &data, QList<WalletInterface::AddressBookEntry> &entries, QString &error);
+    static QString toCSV(const QList<WalletInterface::AddressBookEntry> &entries);
+    static QString toJSON(const QList<WalletInterface::AddressBookEntry> &entries);
+    /**@}*/
+
+private:
+    AddressBookFile() {}
+};
+
+#endif // ADDRESSBOOKFILE_H
@@ -2,11 +2,14 @@
 #include "ui_addressbookpage.h"
 
 #include "addresstablemodel.h"
+#include "addressfilterproxy.h"
 #include "bitcoingui.h"
 #include "editaddressdialog.h"
 #include "csvmodelwriter.h"
+#include "addressbookfile.h"
 #include "guiutil.h"
 
+#include <QApplication>
 #include <QSortFilterProxyModel>
 #include <QClipboard>
 #include <QFileDialog>
@@ -22,7 +25,8 @@ AddressBookPage::AddressBookPage(Mode mode, Tabs tab, QWidget *parent) :
     ui(new Ui::AddressBookPage),
     model(0),
     mode(mode),
-    tab(tab)
+    tab(tab),
+    proxyModel(0)
 {
     ui->setupUi(this);
 
@@ -53,6 +57,8 @@ AddressBookPage::AddressBookPage(Mode mode, Tabs tab, QWidget *parent) :
         ui->labelExplanation->hide();
         break;
     case ReceivingTab:
+        // Imported addresses are sending addresses, we have no keys for them
+        ui->importButton->hide();
         break;
     }
     ui->tableView->setTabKeyNavigation(false);
@@ -94,22 +100,12 @@ void AddressBookPage::setModel(AddressTableModel *model)
     // Refresh list from core
     model->updateList();
 
-    proxyModel = new QSortFilterProxyModel(this);
-    proxyModel->setSourceModel(model);
-    proxyModel->setDynamicSortFilter(true);
-    switch(tab)
-    {
-    case ReceivingTab:
-        // Receive filter
-        proxyModel->setFilterRole(AddressTableModel::TypeRole);
-        proxyModel->setFilterFixedString(AddressTableModel::Receive);
-        break;
-    case SendingTab:
-        // Send filter
-        proxyModel->setFilterRole(AddressTableModel::TypeRole);
-        proxyModel->setFilterFixedString(AddressTableModel::Send);
-        break;
-    }
+    // Switching wallets, the proxy of the previous wallet is no longer needed
+    delete proxyModel;
+    AddressFilterProxy *filterProxy = new AddressFilterProxy(tab == ReceivingTab, this);
+    filterProxy->setSourceModel(model);
+    filterProxy->setDynamicSortFilter(true);
+    proxyModel = filterProxy;
     ui->tableView->setModel(proxyModel);
     ui->tableView->sortByColumn(0, Qt::AscendingOrder);
 
@@ -188,13 +184,12 @@ void AddressBookPage::on_newAddressButton_clicked()
     {
         // Select row for newly created address
         QString address = dlg.getAddress();
-        QModelIndexList lst = proxyModel->match(proxyModel->index(0,
-                          AddressTableModel::Address, QModelIndex()),
-                          Qt::EditRole, address, 1, Qt::MatchExactly);
-        if(!lst.isEmpty())
+        QModelIndex index = proxyModel->mapFromSource(
+                model->index(model->lookupAddress(address), AddressTableModel::Address, QModelIndex()));
+        if(index.isValid())
         {
             ui->tableView->setFocus();
-            ui->tableView->selectRow(lst.at(0).row());
+            ui->tableView->selectRow(index.row());
         }
     }
 }
@@ -276,29 +271,84 @@ void AddressBookPage::done(int retval)
 
 void AddressBookPage::exportClicked()
 {
-    // CSV is currently the only supported format
     QString filename = QFileDialog::getSaveFileName(
             this,
             tr("Export Address Book Data"),
             QDir::currentPath(),
-            tr("Comma separated file (*.csv)"));
+            tr("Comma separated file (*.csv);;JSON file (*.json)"));
 
     if (filename.isNull()) return;
 
-    CSVModelWriter writer(filename);
+    bool written = false;
+    if(AddressBookFile::formatForFile(filename) == AddressBookFile::JSON)
+    {
+        // Entries of the current tab, in the order shown
+        QList<WalletInterface::AddressBookEntry> entries;
+        entries.reserve(proxyModel->rowCount());
+        for(int row = 0; row < proxyModel->rowCount(); ++row)
+        {
+            entries.append(WalletInterface::AddressBookEntry(
+                    proxyModel->index(row, AddressTableModel::Address).data(Qt::EditRole).toString(),
+                    proxyModel->index(row, AddressTableModel::Label).data(Qt::EditRole).toString(),
+                    tab == ReceivingTab));
+        }
+        written = AddressBookFile::write(filename, entries);
+    }
+    else
+    {
+        CSVModelWriter writer(filename);
 
-    // name, column, role
-    writer.setModel(proxyModel);
-    writer.addColumn("Label", AddressTableModel::Label, Qt::EditRole);
-    writer.addColumn("Address", AddressTableModel::Address, Qt::EditRole);
+        // name, column, role
+        writer.setModel(proxyModel);
+        writer.addColumn("Label", AddressTableModel::Label, Qt::EditRole);
+        writer.addColumn("Address", AddressTableModel::Address, Qt::EditRole);
+        written = writer.write();
+    }
 
-    if(!writer.write())
+    if(!written)
     {
         QMessageBox::critical(this, tr("Error exporting"), tr("Could not write to file %1.").arg(filename),
                               QMessageBox::Abort, QMessageBox::Abort);
     }
 }
 
+void AddressBookPage::on_importButton_clicked()
+{
+    if(!model)
+        return;
+    QString filename = QFileDialog::getOpenFileName(
+            this,
+            tr("Import Address Book Data"),
+            QDir::currentPath(),
+            tr("Address book files (*.csv *.json);;All files (*)"));
+
+    if (filename.isNull()) return;
+
+    QList<WalletInterface::AddressBookEntry> entries;
+    QString error;
+    if(!AddressBookFile::read(filename, entries, error))
+    {
+        QMessageBox::critical(this, tr("Error importing"), tr("Could not read file %1: %2").arg(filename, error),
+                              QMessageBox::Abort, QMessageBox::Abort);
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    AddressTableModel::ImportResult result = model->importAddresses(entries);
+    QApplication::restoreOverrideCursor();
+
+    if(result.writeFailed)
+    {
+        QMessageBox::critical(this, tr("Error importing"), tr("Could not write the address book to the wallet."),
+                              QMessageBox::Abort, QMessageBox::Abort);
+        return;
+    }
+    QMessageBox::information(this, tr("Import finished"),
+            tr("Imported %n address(es).", "", result.imported) + "<br>" +
+            tr("Skipped %n invalid address(es).", "", result.invalid) + "<br>" +
+            tr("Skipped %n address(es) already in the address book.", "", result.duplicate));
+}
+
 void AddressBookPage::on_showQRCode_clicked()
 {
 #ifdef USE_QRCODE
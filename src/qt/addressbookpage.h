@@ -55,6 +55,8 @@ private:
 private slots:
     void on_deleteButton_clicked();
     void on_newAddressButton_clicked();
+    /** Add the addresses in a file as sending addresses */
+    void on_importButton_clicked();
     /** Copy address of currently selected address entry to clipboard */
     void on_copyToClipboard_clicked();
     void on_signMessage_clicked();
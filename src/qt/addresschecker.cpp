@@ -0,0 +1,165 @@
+#include "addresschecker.h"
+
+#include <QtConcurrentMap>
+
+#include <openssl/sha.h>
+
+#include <cstring>
+
+static const char BASE58_CHARS[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// Value of each ASCII character in base58, -1 if it is not a base58 character
+static const signed char BASE58_VALUES[128] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8,-1,-1,-1,-1,-1,-1,
+    -1, 9,10,11,12,13,14,15,16,-1,17,18,19,20,21,-1,
+    22,23,24,25,26,27,28,29,30,31,32,-1,-1,-1,-1,-1,
+    -1,33,34,35,36,37,38,39,40,41,42,43,-1,44,45,46,
+    47,48,49,50,51,52,53,54,55,56,57,-1,-1,-1,-1,-1
+};
+
+// Addresses checked by one task of checkBatch
+static const int BATCH_CHUNK_SIZE = 256;
+
+AddressChecker::Result AddressChecker::decode(const QChar *str, int len, unsigned char *out)
+{
+    // Decoded addresses have a fixed size, so the big number fits in a fixed buffer:
+    // multiply by 58 and add each digit, failing when the number overflows 25 bytes.
+    memset(out, 0, DECODED_SIZE);
+    int leadingOnes = 0;
+    bool leading = true;
+    for(int i = 0; i < len; ++i)
+    {
+        ushort c = str[i].unicode();
+        int carry = c < 128 ? BASE58_VALUES[c] : -1;
+        if(carry < 0)
+            return InvalidCharacter;
+        if(leading && carry == 0)
+            ++leadingOnes;
+        else
+            leading = false;
+        for(int j = DECODED_SIZE - 1; j >= 0; --j)
+        {
+            carry += 58 * out[j];
+            out[j] = carry & 0xff;
+            carry >>= 8;
+        }
+        if(carry)
+            return InvalidLength;
+    }
+
+    // Each leading '1' encodes a leading zero byte, no more and no less
+    int leadingZeros = 0;
+    while(leadingZeros < DECODED_SIZE && out[leadingZeros] == 0)
+        ++leadingZeros;
+    if(len < MIN_ADDRESS_LENGTH || leadingZeros != leadingOnes)
+        return InvalidLength;
+    return InvalidChecksum;
+}
+
+bool AddressChecker::verifyChecksum(const unsigned char *decoded)
+{
+    unsigned char hash1[SHA256_DIGEST_LENGTH];
+    unsigned char hash2[SHA256_DIGEST_LENGTH];
+    SHA256(decoded, DECODED_SIZE - 4, hash1);
+    SHA256(hash1, sizeof(hash1), hash2);
+    return memcmp(hash2, decoded + DECODED_SIZE - 4, 4) == 0;
+}
+
+AddressChecker::Result AddressChecker::check(const QString &address, int version)
+{
+    unsigned char decoded[DECODED_SIZE];
+    Result result = decode(address.constData(), address.size(), decoded);
+    if(result != InvalidChecksum)
+        return result;
+    if(!verifyChecksum(decoded))
+        return InvalidChecksum;
+    if(version >= 0 && decoded[0] != version)
+        return WrongVersion;
+    return Valid;
+}
+
+int AddressChecker::version(const QString &address)
+{
+    unsigned char decoded[DECODED_SIZE];
+    if(decode(address.constData(), address.size(), decoded) != InvalidChecksum || !verifyChecksum(decoded))
+        return -1;
+    return decoded[0];
+}
+
+struct AddressCheckChunk
+{
+    const QStringList *addresses;
+    int begin;
+    int end;
+    int version;
+    AddressChecker::Result *results;
+};
+
+static void checkChunk(AddressCheckChunk &chunk)
+{
+    for(int i = chunk.begin; i < chunk.end; ++i)
+        chunk.results[i] = AddressChecker::check(chunk.addresses->at(i), chunk.version);
+}
+
+QVector<AddressChecker::Result> AddressChecker::checkBatch(const QStringList &addresses, int version)
+{
+    QVector<Result> results(addresses.size());
+    QList<AddressCheckChunk> chunks;
+    for(int begin = 0; begin < addresses.size(); begin += BATCH_CHUNK_SIZE)
+    {
+        AddressCheckChunk chunk;
+        chunk.addresses = &addresses;
+        chunk.begin = begin;
+        chunk.end = qMin(begin + BATCH_CHUNK_SIZE, addresses.size());
+        chunk.version = version;
+        chunk.results = results.data();
+        chunks.append(chunk);
+    }
+    if(chunks.size() == 1)
+        checkChunk(chunks[0]);
+    else
+        QtConcurrent::blockingMap(chunks, checkChunk);
+    return results;
+}
+
+QString AddressChecker::encode(unsigned char version, const unsigned char *hash160)
+{
+    unsigned char data[DECODED_SIZE];
+    data[0] = version;
+    memcpy(data + 1, hash160, 20);
+    unsigned char hash1[SHA256_DIGEST_LENGTH];
+    unsigned char hash2[SHA256_DIGEST_LENGTH];
+    SHA256(data, DECODED_SIZE - 4, hash1);
+    SHA256(hash1, sizeof(hash1), hash2);
+    memcpy(data + DECODED_SIZE - 4, hash2, 4);
+
+    // Repeated division by 58, producing the digits backwards
+    char digits[40];
+    int len = 0;
+    int start = 0;
+    while(start < DECODED_SIZE && data[start] == 0)
+        ++start;
+    for(int i = start; i < DECODED_SIZE; )
+    {
+        int remainder = 0;
+        for(int j = i; j < DECODED_SIZE; ++j)
+        {
+            int value = remainder * 256 + data[j];
+            data[j] = value / 58;
+            remainder = value % 58;
+        }
+        digits[len++] = BASE58_CHARS[remainder];
+        while(i < DECODED_SIZE && data[i] == 0)
+            ++i;
+    }
+    for(int i = 0; i < start; ++i)
+        digits[len++] = '1';
+
+    QString address(len, QChar());
+    for(int i = 0; i < len; ++i)
+        address[i] = QChar(digits[len - 1 - i]);
+    return address;
+}
@@ -0,0 +1,49 @@
+#ifndef ADDRESSCHECKER_H
+#define ADDRESSCHECKER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/** Fast Base58Check validation of addresses, without going through the wallet. Checks the
+    character set, the length, the checksum and optionally the version byte, which is what
+    decides validity of pay-to addresses. Used for bulk imports and live feedback in address fields.
+ */
+class AddressChecker
+{
+public:
+    enum Result
+    {
+        Valid,
+        InvalidCharacter,   /**< Not a base58 character */
+        InvalidLength,      /**< Does not decode to a version byte, 20 byte hash and checksum */
+        InvalidChecksum,
+        WrongVersion        /**< Valid, but for another chain or address type */
+    };
+
+    /** Number of bytes in a decoded address: version, hash160 and checksum */
+    static const int DECODED_SIZE = 25;
+    /** Shortest encoding of a 25 byte address */
+    static const int MIN_ADDRESS_LENGTH = 26;
+
+    /** Check a single address. version is the expected version byte, or -1 to accept any version. */
+    static Result check(const QString &address, int version = -1);
+    /** Check many addresses, spread over the available cores */
+    static QVector<Result> checkBatch(const QStringList &addresses, int version = -1);
+    /** Version byte of a valid address, -1 if the address does not decode or fails the checksum */
+    static int version(const QString &address);
+
+    /** Decode into out, which must have room for DECODED_SIZE bytes. Returns InvalidChecksum
+        if the address decodes but the checksum is not verified yet, so call verifyChecksum next.
+     */
+    static Result decode(const QChar *str, int len, unsigned char *out);
+    /** Verify the double SHA-256 checksum of a decoded address */
+    static bool verifyChecksum(const unsigned char *decoded);
+    /** Encode a version byte and hash160 as an address */
+    static QString encode(unsigned char version, const unsigned char *hash160);
+
+private:
+    AddressChecker() {}
+};
+
+#endif // ADDRESSCHECKER_H
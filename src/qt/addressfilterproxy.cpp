@@ -0,0 +1,23 @@
+#include "addressfilterproxy.h"
+#include "addresstablemodel.h"
+
+AddressFilterProxy::AddressFilterProxy(bool receiving, QObject *parent) :
+    QSortFilterProxyModel(parent),
+    model(0),
+    receiving(receiving)
+{
+}
+
+void AddressFilterProxy::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    // Also reached through a QSortFilterProxyModel/QAbstractProxyModel pointer, so resolve the
+    // concrete model here instead of in a non-virtual overload
+    model = qobject_cast<AddressTableModel*>(sourceModel);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+bool AddressFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    return model && model->isReceiving(sourceRow) == receiving;
+}
@@ -0,0 +1,27 @@
+#ifndef ADDRESSFILTERPROXY_H
+#define ADDRESSFILTERPROXY_H
+
+#include <QSortFilterProxyModel>
+
+class AddressTableModel;
+
+/** Sending or receiving part of the address book. Filters on the entry type kept by the
+    AddressTableModel, instead of comparing the string TypeRole of every row.
+ */
+class AddressFilterProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit AddressFilterProxy(bool receiving, QObject *parent = 0);
+
+    void setSourceModel(QAbstractItemModel *sourceModel);
+
+protected:
+    bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const;
+
+private:
+    AddressTableModel *model;
+    bool receiving;
+};
+
+#endif // ADDRESSFILTERPROXY_H
@@ -1,14 +1,13 @@
 #include "addresstablemodel.h"
 #include "guiutil.h"
 #include "walletmodel.h"
-
-#include <coin/Address.h>
-#include <coinWallet/Wallet.h>
-
-#include <boost/foreach.hpp>
+#include "walletinterface.h"
+#include "addresschecker.h"
 
 #include <QFont>
 #include <QColor>
+#include <QHash>
+#include <QSet>
 
 const QString AddressTableModel::Send = "S";
 const QString AddressTableModel::Receive = "R";
@@ -32,29 +31,52 @@ struct AddressTableEntry
 // Private implementation
 struct AddressTablePriv
 {
-    Wallet *wallet;
+    WalletInterface *wallet;
     QList<AddressTableEntry> cachedAddressTable;
+    // Row of every address in cachedAddressTable
+    QHash<QString, int> rowIndex;
 
-    AddressTablePriv(Wallet *wallet):
+    AddressTablePriv(WalletInterface *wallet):
             wallet(wallet) {}
 
     void refreshAddressTable()
     {
         cachedAddressTable.clear();
 
-        CRITICAL_BLOCK(wallet->cs_wallet)
+        foreach(const WalletInterface::AddressBookEntry &entry, wallet->getAddressBook())
         {
-            for(std::map<ChainAddress, std::string>::const_iterator item = wallet->mapAddressBook.begin(); item !=  wallet->mapAddressBook.end(); ++item)
-            {
-                const ChainAddress& address = item->first;
-                PubKeyHash pubKeyHash = address.getPubKeyHash();
-                const std::string& strName = item->second;
-                bool fMine = wallet->haveKey(pubKeyHash);
-                cachedAddressTable.append(AddressTableEntry(fMine ? AddressTableEntry::Receiving : AddressTableEntry::Sending,
-                                  QString::fromStdString(strName),
-                                  QString::fromStdString(address.toString())));
-            }
+            cachedAddressTable.append(AddressTableEntry(entry.mine ? AddressTableEntry::Receiving : AddressTableEntry::Sending,
+                              entry.label, entry.address));
         }
+        rowIndex.clear();
+        reindex(0);
+    }
+
+    /* Update the row index from row on, after rows were inserted or removed before it */
+    void reindex(int from)
+    {
+        rowIndex.reserve(cachedAddressTable.size());
+        for(int row = from; row < cachedAddressTable.size(); ++row)
+            rowIndex.insert(cachedAddressTable.at(row).address, row);
+    }
+
+    void append(const AddressTableEntry &entry)
+    {
+        rowIndex.insert(entry.address, cachedAddressTable.size());
+        cachedAddressTable.append(entry);
+    }
+
+    void remove(int first, int last)
+    {
+        for(int row = first; row <= last; ++row)
+            rowIndex.remove(cachedAddressTable.at(row).address);
+        cachedAddressTable.erase(cachedAddressTable.begin() + first, cachedAddressTable.begin() + last + 1);
+        reindex(first);
+    }
+
+    int lookup(const QString &address) const
+    {
+        return rowIndex.value(address, -1);
     }
 
     int size()
@@ -75,7 +97,7 @@ struct AddressTablePriv
     }
 };
 
-AddressTableModel::AddressTableModel(Wallet *wallet, WalletModel *parent) :
+AddressTableModel::AddressTableModel(WalletInterface *wallet, WalletModel *parent) :
     QAbstractTableModel(parent),walletModel(parent),wallet(wallet),priv(0)
 {
     columns << tr("Label") << tr("Address");
@@ -160,27 +182,32 @@ bool AddressTableModel::setData(const QModelIndex & index, const QVariant & valu
         switch(index.column())
         {
         case Label:
-            wallet->SetAddressBookName(rec->address.toStdString(), value.toString().toStdString());
+            wallet->setAddressBookName(rec->address, value.toString());
             rec->label = value.toString();
             break;
         case Address:
             // Refuse to set invalid address, set error status and return false
-            if(!walletModel->validateAddress(value.toString()))
+            if(!validateAddress(value.toString()))
             {
                 editStatus = INVALID_ADDRESS;
                 return false;
             }
+            if(value.toString() == rec->address)
+                break;
+            // Refuse to merge two entries, the address book has one label per address
+            if(priv->lookup(value.toString()) != -1)
+            {
+                editStatus = DUPLICATE_ADDRESS;
+                return false;
+            }
             // Double-check that we're not overwriting a receiving address
             if(rec->type == AddressTableEntry::Sending)
             {
-                CRITICAL_BLOCK(wallet->cs_wallet)
-                {
-                    // Remove old entry
-                    wallet->DelAddressBookName(rec->address.toStdString());
-                    // Add new entry with new address
-                    wallet->SetAddressBookName(value.toString().toStdString(), rec->label.toStdString());
-                }
+                // Replace old entry with one for the new address
+                wallet->changeAddress(rec->address, value.toString(), rec->label);
 
+                priv->rowIndex.remove(rec->address);
+                priv->rowIndex.insert(value.toString(), index.row());
                 rec->address = value.toString();
             }
             break;
@@ -237,63 +264,187 @@ QModelIndex AddressTableModel::index(int row, int column, const QModelIndex & pa
 
 void AddressTableModel::updateList()
 {
-    // Update address book model from Bitcoin core
-    beginResetModel();
-    priv->refreshAddressTable();
-    endResetModel();
+    // Bring the address book model in line with Bitcoin core, with row level notifications so that
+    // views keep their selection and scroll position
+    QList<WalletInterface::AddressBookEntry> book = wallet->getAddressBook();
+
+    QSet<QString> present;
+    present.reserve(book.size());
+    QList<AddressTableEntry> added;
+    foreach(const WalletInterface::AddressBookEntry &entry, book)
+    {
+        present.insert(entry.address);
+        AddressTableEntry::Type type = entry.mine ? AddressTableEntry::Receiving : AddressTableEntry::Sending;
+        int row = priv->lookup(entry.address);
+        if(row == -1)
+        {
+            added.append(AddressTableEntry(type, entry.label, entry.address));
+            continue;
+        }
+        AddressTableEntry *rec = priv->index(row);
+        if(rec->type != type || rec->label != entry.label)
+        {
+            rec->type = type;
+            rec->label = entry.label;
+            emit dataChanged(index(row, 0, QModelIndex()), index(row, columns.size() - 1, QModelIndex()));
+        }
+    }
+
+    // Remove entries that are gone, a range of adjacent rows at a time, from the back so that
+    // the rows still to remove keep their numbers
+    for(int last = priv->size() - 1; last >= 0; --last)
+    {
+        if(present.contains(priv->cachedAddressTable.at(last).address))
+            continue;
+        int first = last;
+        while(first > 0 && !present.contains(priv->cachedAddressTable.at(first - 1).address))
+            --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        priv->remove(first, last);
+        endRemoveRows();
+        last = first;
+    }
+
+    if(!added.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), priv->size(), priv->size() + added.size() - 1);
+        foreach(const AddressTableEntry &entry, added)
+            priv->append(entry);
+        endInsertRows();
+    }
+}
+
+void AddressTableModel::updateEntry(const QString &address, const QString &label, bool isMine)
+{
+    AddressTableEntry::Type type = isMine ? AddressTableEntry::Receiving : AddressTableEntry::Sending;
+    int row = priv->lookup(address);
+    if(row == -1)
+    {
+        beginInsertRows(QModelIndex(), priv->size(), priv->size());
+        priv->append(AddressTableEntry(type, label, address));
+        endInsertRows();
+        return;
+    }
+    AddressTableEntry *rec = priv->index(row);
+    if(rec->type != type || rec->label != label)
+    {
+        rec->type = type;
+        rec->label = label;
+        emit dataChanged(index(row, 0, QModelIndex()), index(row, columns.size() - 1, QModelIndex()));
+    }
 }
 
 QString AddressTableModel::addRow(const QString &type, const QString &label, const QString &address)
 {
-    std::string strLabel = label.toStdString();
-    std::string strAddress = address.toStdString();
+    QString strAddress = address;
 
     editStatus = OK;
 
     if(type == Send)
     {
-        if(!walletModel->validateAddress(address))
+        if(!validateAddress(address))
         {
             editStatus = INVALID_ADDRESS;
             return QString();
         }
         // Check for duplicate addresses
-        CRITICAL_BLOCK(wallet->cs_wallet)
+        if(wallet->haveAddressBookEntry(address))
         {
-            if(wallet->mapAddressBook.count(strAddress))
-            {
-                editStatus = DUPLICATE_ADDRESS;
-                return QString();
-            }
+            editStatus = DUPLICATE_ADDRESS;
+            return QString();
         }
     }
     else if(type == Receive)
     {
         // Generate a new address to associate with given label
-        WalletModel::UnlockContext ctx(walletModel->requestUnlock());
+        WalletModel::UnlockContext ctx(walletModel ? walletModel->requestUnlock() :
+                                                     WalletModel::UnlockContext(0, true, false));
         if(!ctx.isValid())
         {
             // Unlock wallet failed or was cancelled
             editStatus = WALLET_UNLOCK_FAILURE;
             return QString();
         }
-        std::vector<unsigned char> newKey;
-        if(!wallet->GetKeyFromPool(newKey, true))
+        if(!wallet->getNewAddress(strAddress))
         {
             editStatus = KEY_GENERATION_FAILURE;
             return QString();
         }
-        strAddress = wallet->chain().getAddress(toPubKeyHash(newKey)).toString();
     }
     else
     {
         return QString();
     }
-    // Add entry and update list
-    CRITICAL_BLOCK(wallet->cs_wallet)
-        wallet->SetAddressBookName(strAddress, strLabel);
-    updateList();
-    return QString::fromStdString(strAddress);
+    // Add entry and update the row for it
+    wallet->setAddressBookName(strAddress, label);
+    updateEntry(strAddress, label, type == Receive);
+    return strAddress;
+}
+
+AddressTableModel::ImportResult AddressTableModel::importAddresses(const QList<WalletInterface::AddressBookEntry> &entries)
+{
+    ImportResult result;
+
+    QStringList addresses;
+    addresses.reserve(entries.size());
+    foreach(const WalletInterface::AddressBookEntry &entry, entries)
+        addresses.append(entry.address.trimmed());
+    QVector<AddressChecker::Result> checks = AddressChecker::checkBatch(addresses);
+
+    // Addresses accepted so far, the book itself is looked up in the row index
+    QSet<QString> known;
+    known.reserve(entries.size());
+
+    // Once the checksum is verified only the version byte decides if the chain accepts an
+    // address, so ask the wallet once per version instead of once per address
+    QHash<int, bool> versionAccepted;
+    QList<WalletInterface::AddressBookEntry> accepted;
+    for(int i = 0; i < addresses.size(); ++i)
+    {
+        const QString &address = addresses.at(i);
+        if(checks.at(i) != AddressChecker::Valid)
+        {
+            ++result.invalid;
+            continue;
+        }
+        int version = AddressChecker::version(address);
+        QHash<int, bool>::iterator vi = versionAccepted.find(version);
+        if(vi == versionAccepted.end())
+            vi = versionAccepted.insert(version, validateAddress(address));
+        if(!vi.value())
+        {
+            ++result.invalid;
+            continue;
+        }
+        if(priv->lookup(address) != -1 || known.contains(address))
+        {
+            ++result.duplicate;
+            continue;
+        }
+        known.insert(address);
+        // Importing a label for one of our own addresses must not make it a sending address
+        accepted.append(WalletInterface::AddressBookEntry(address, entries.at(i).label, wallet->isMine(address)));
+    }
+    if(accepted.isEmpty())
+        return result;
+
+    if(!wallet->setAddressBookNames(accepted))
+    {
+        result.writeFailed = true;
+        return result;
+    }
+
+    int first = priv->size();
+    beginInsertRows(QModelIndex(), first, first + accepted.size() - 1);
+    priv->cachedAddressTable.reserve(first + accepted.size());
+    priv->rowIndex.reserve(first + accepted.size());
+    foreach(const WalletInterface::AddressBookEntry &entry, accepted)
+        priv->append(AddressTableEntry(entry.mine ? AddressTableEntry::Receiving : AddressTableEntry::Sending,
+                                       entry.label, entry.address));
+    endInsertRows();
+
+    result.imported = accepted.size();
+    return result;
 }
 
 bool AddressTableModel::removeRows(int row, int count, const QModelIndex & parent)
@@ -306,12 +457,26 @@ bool AddressTableModel::removeRows(int row, int count, const QModelIndex & paren
         // Also refuse to remove receiving addresses.
         return false;
     }
-    CRITICAL_BLOCK(wallet->cs_wallet)
+    wallet->delAddressBookName(rec->address);
+    beginRemoveRows(QModelIndex(), row, row);
+    priv->remove(row, row);
+    endRemoveRows();
+    return true;
+}
+
+void AddressTableModel::addMemoryUsage(MemoryUsage &usage, const QString &walletName) const
+{
+    qint64 bytes = 0;
+    foreach(const AddressTableEntry &entry, priv->cachedAddressTable)
     {
-        wallet->DelAddressBookName(rec->address.toStdString());
+        // QList stores large items by pointer
+        bytes += sizeof(void*) + sizeof(AddressTableEntry);
+        bytes += (entry.label.capacity() + entry.address.capacity()) * sizeof(QChar);
     }
-    updateList();
-    return true;
+    // Row index: bucket array plus a node per address, which shares the string data of the table
+    bytes += priv->rowIndex.capacity() * sizeof(void*);
+    bytes += priv->rowIndex.size() * (3 * sizeof(void*) + sizeof(QString) + sizeof(int));
+    usage.append(MemoryUsageEntry(tr("%1: address table").arg(walletName), priv->cachedAddressTable.size(), bytes));
 }
 
 void AddressTableModel::update()
@@ -323,29 +488,23 @@ void AddressTableModel::update()
  */
 QString AddressTableModel::labelForAddress(const QString &address) const
 {
-    CRITICAL_BLOCK(wallet->cs_wallet)
-    {
-        ChainAddress address_parsed(address.toStdString());
-        std::map<ChainAddress, std::string>::iterator mi = wallet->mapAddressBook.find(address_parsed);
-        if (mi != wallet->mapAddressBook.end())
-        {
-            return QString::fromStdString(mi->second);
-        }
-    }
-    return QString();
+    return wallet->labelForAddress(address);
+}
+
+/* Without a wallet model (benchmarks, load tests) every address is accepted.
+ */
+bool AddressTableModel::validateAddress(const QString &address) const
+{
+    return !walletModel || walletModel->validateAddress(address);
 }
 
 int AddressTableModel::lookupAddress(const QString &address) const
 {
-    QModelIndexList lst = match(index(0, Address, QModelIndex()),
-                                Qt::EditRole, address, 1, Qt::MatchExactly);
-    if(lst.isEmpty())
-    {
-        return -1;
-    }
-    else
-    {
-        return lst.at(0).row();
-    }
+    return priv->lookup(address);
 }
 
+bool AddressTableModel::isReceiving(int row) const
+{
+    AddressTableEntry *rec = priv->index(row);
+    return rec && rec->type == AddressTableEntry::Receiving;
+}
@@ -4,8 +4,10 @@
 #include <QAbstractTableModel>
 #include <QStringList>
 
+#include "memoryusage.h"
+#include "walletinterface.h"
+
 class AddressTablePriv;
-class Wallet;
 class WalletModel;
 
 /**
@@ -15,7 +17,7 @@ class AddressTableModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
-    explicit AddressTableModel(Wallet *wallet, WalletModel *parent = 0);
+    explicit AddressTableModel(WalletInterface *wallet, WalletModel *parent = 0);
     ~AddressTableModel();
 
     enum ColumnIndex {
@@ -36,6 +38,16 @@ public:
         KEY_GENERATION_FAILURE /**< Generating a new public key for a receiving address failed */
     };
 
+    /** Outcome of a bulk import */
+    struct ImportResult
+    {
+        ImportResult(): imported(0), invalid(0), duplicate(0), writeFailed(false) {}
+        int imported;
+        int invalid;    /**< Unparseable address, or for another chain */
+        int duplicate;  /**< Already in the address book, or earlier in the import */
+        bool writeFailed; /**< The wallet file could not be updated, nothing was imported */
+    };
+
     static const QString Send; /**< Specifies send address */
     static const QString Receive; /**< Specifies receive address */
 
@@ -56,10 +68,21 @@ public:
      */
     QString addRow(const QString &type, const QString &label, const QString &address);
 
-    /* Update address list from core. Invalidates any indices.
+    /* Add many sending addresses to the model. Addresses are validated in parallel, written to the
+       wallet in a single transaction and appended with a single row insertion, instead of the write
+       and full reload per address of addRow.
+     */
+    ImportResult importAddresses(const QList<WalletInterface::AddressBookEntry> &entries);
+
+    /* Update address list from core. Entries that changed, were added or removed are signalled
+       per row, indices of the other entries stay valid.
      */
     void updateList();
 
+    /* Add or update a single entry, without reading the rest of the address book.
+     */
+    void updateEntry(const QString &address, const QString &label, bool isMine);
+
     /* Look up label for address in address book, if not found return empty string.
      */
     QString labelForAddress(const QString &address) const;
@@ -69,15 +92,25 @@ public:
      */
     int lookupAddress(const QString &address) const;
 
+    /* Whether the entry in a row is a receiving address. Cheaper than TypeRole for filtering.
+     */
+    bool isReceiving(int row) const;
+
     EditStatus getEditStatus() const { return editStatus; }
 
+    /* Add the estimated memory used by the cached address table.
+     */
+    void addMemoryUsage(MemoryUsage &usage, const QString &walletName) const;
+
 private:
     WalletModel *walletModel;
-    Wallet *wallet;
+    WalletInterface *wallet;
     AddressTablePriv *priv;
     QStringList columns;
     EditStatus editStatus;
 
+    bool validateAddress(const QString &address) const;
+
 signals:
     void defaultAddressChanged(const QString &address);
 
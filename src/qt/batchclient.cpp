@@ -0,0 +1,165 @@
+#include "batchclient.h"
+
+#include <coinHTTP/Server.h>
+#include <coinHTTP/Client.h>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <stdexcept>
+
+/*
+   Worker: take the next batch of calls, post it as a JSON-RPC batch array and store the replies
+   by id, until all calls are sent. Each worker has its own client and posts one batch at a time.
+ */
+static void sendBatches(const std::string *url, const Auth *auth, const json_spirit::Array *calls, int batchSize,
+                        size_t *next, boost::mutex *nextMutex, std::vector<json_spirit::Object> *replies)
+{
+    Client client;
+    while(true)
+    {
+        size_t begin;
+        {
+            boost::mutex::scoped_lock lock(*nextMutex);
+            begin = *next;
+            *next += batchSize;
+        }
+        if(begin >= calls->size())
+            return;
+        size_t end = std::min(calls->size(), begin + batchSize);
+
+        json_spirit::Array batch(calls->begin() + begin, calls->begin() + end);
+        Reply reply = client.post(*url, json_spirit::write(batch), auth->headers());
+
+        json_spirit::Value value;
+        if(!json_spirit::read(reply.content, value) || value.type() != json_spirit::array_type)
+        {
+            // The whole batch failed, e.g. on an authentication or HTTP error
+            json_spirit::Object error;
+            error.push_back(json_spirit::Pair("code", (int)reply.status));
+            error.push_back(json_spirit::Pair("message", "HTTP error, no batch reply"));
+            for(size_t i = begin; i < end; ++i)
+                (*replies)[i].push_back(json_spirit::Pair("error", error));
+            continue;
+        }
+        BatchClient::storeReplies(value.get_array(), begin, end, *replies);
+    }
+}
+
+bool BatchClient::tokenize(const std::string &line, std::vector<std::string> &tokens)
+{
+    tokens.clear();
+    std::string token;
+    bool fToken = false;    // Also true for an empty quoted parameter
+    bool fQuoted = false;
+    for(size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if(c == '\\' && i + 1 < line.size())
+        {
+            token += line[++i];
+            fToken = true;
+        }
+        else if(c == '"')
+        {
+            fQuoted = !fQuoted;
+            fToken = true;
+        }
+        else if(!fQuoted && (c == ' ' || c == '\t' || c == '\r'))
+        {
+            if(fToken)
+                tokens.push_back(token);
+            token.clear();
+            fToken = false;
+        }
+        else
+        {
+            token += c;
+            fToken = true;
+        }
+    }
+    if(fToken)
+        tokens.push_back(token);
+    return !tokens.empty() && (tokens[0].empty() || tokens[0][0] != '#');
+}
+
+json_spirit::Array BatchClient::readCalls(std::istream &in)
+{
+    json_spirit::Array calls;
+    std::string line;
+    std::vector<std::string> tokens;
+    while(std::getline(in, line))
+    {
+        if(!tokenize(line, tokens))
+            continue;
+
+        // Build the call the same way as a single command line call, so that parameters are
+        // converted alike, and number it by its position for matching the replies
+        std::string method = tokens[0];
+        tokens.erase(tokens.begin());
+        json_spirit::Value request;
+        if(!json_spirit::read(RPC::content(method, tokens), request) || request.type() != json_spirit::obj_type)
+            throw std::runtime_error("Could not encode the call to " + method);
+        json_spirit::Object call;
+        BOOST_FOREACH(const json_spirit::Pair& pair, request.get_obj())
+        {
+            if(pair.name_ != "id")
+                call.push_back(pair);
+        }
+        call.push_back(json_spirit::Pair("id", (int)calls.size()));
+        calls.push_back(call);
+    }
+    return calls;
+}
+
+void BatchClient::storeReplies(const json_spirit::Array &reply, size_t begin, size_t end, std::vector<json_spirit::Object> &replies)
+{
+    BOOST_FOREACH(const json_spirit::Value& item, reply)
+    {
+        if(item.type() != json_spirit::obj_type)
+            continue;
+        json_spirit::Value id = json_spirit::find_value(item.get_obj(), "id");
+        if(id.type() == json_spirit::int_type && id.get_int() >= (int)begin && id.get_int() < (int)end)
+            replies[id.get_int()] = item.get_obj();
+    }
+}
+
+int BatchClient::writeResults(const std::vector<json_spirit::Object> &replies, std::ostream &out)
+{
+    int ret = 0;
+    BOOST_FOREACH(const json_spirit::Object& reply, replies)
+    {
+        json_spirit::Value error = json_spirit::find_value(reply, "error");
+        if(reply.empty() || error.type() != json_spirit::null_type)
+        {
+            out << "error: " << (reply.empty() ? "no reply" : json_spirit::write(error)) << "\n";
+            ret = 1;
+        }
+        else
+        {
+            out << json_spirit::write(json_spirit::find_value(reply, "result")) << "\n";
+        }
+    }
+    return ret;
+}
+
+int BatchClient::run(std::istream &in, std::ostream &out, const std::string &url, const Auth &auth, int batchSize, int concurrency)
+{
+    json_spirit::Array calls = readCalls(in);
+
+    if(batchSize < 1)
+        batchSize = 1;
+    if(concurrency < 1)
+        concurrency = 1;
+
+    std::vector<json_spirit::Object> replies(calls.size());
+    size_t next = 0;
+    boost::mutex nextMutex;
+    boost::thread_group workers;
+    for(int i = 0; i < concurrency; ++i)
+        workers.create_thread(boost::bind(&sendBatches, &url, &auth, &calls, batchSize, &next, &nextMutex, &replies));
+    workers.join_all();
+
+    return writeResults(replies, out);
+}
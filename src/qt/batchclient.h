@@ -0,0 +1,37 @@
+#ifndef BATCHCLIENT_H
+#define BATCHCLIENT_H
+
+#include <coinHTTP/RPC.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+class Auth;
+
+/** Command line JSON-RPC client for batches of calls. Reads one RPC command per line,
+    "method param1 param2 ...", with double quotes around parameters that contain spaces or are
+    empty, backslash escapes and lines starting with # skipped. The calls are sent as JSON-RPC batch arrays from a number of worker
+    threads, and the result of each is written on its own line, in input order.
+ */
+class BatchClient
+{
+public:
+    /** Split a command line into its method and parameters. Returns false for blank lines and comments. */
+    static bool tokenize(const std::string &line, std::vector<std::string> &tokens);
+    /** Read the calls from in. Each call is encoded the same way as a single command line call,
+        and gets its position in the input as id.
+     */
+    static json_spirit::Array readCalls(std::istream &in);
+    /** Store the replies of a batch reply array by id, ignoring replies whose id is not in [begin, end). */
+    static void storeReplies(const json_spirit::Array &reply, size_t begin, size_t end, std::vector<json_spirit::Object> &replies);
+    /** Write the results, or the errors, in order. Returns 1 if any call failed, 0 otherwise. */
+    static int writeResults(const std::vector<json_spirit::Object> &replies, std::ostream &out);
+
+    /** Read the calls from in and send them batchSize at a time on concurrency connections. Returns
+        the exit code of the client.
+     */
+    static int run(std::istream &in, std::ostream &out, const std::string &url, const Auth &auth, int batchSize, int concurrency);
+};
+
+#endif // BATCHCLIENT_H
@@ -0,0 +1,67 @@
+#include <QApplication>
+#include <QScopedPointer>
+#include <QStringList>
+
+#include "benchmark.h"
+#include "modelbench.h"
+#include "uibench.h"
+
+#include <iostream>
+#include <cstring>
+
+static const char *USAGE = "Usage: bitcoin-qt_bench [-sizes=10000,100000,1000000] [-iterations=5] [-ui] [-frames=200] [-output=<file>]\n";
+
+// Writes the results as JSON to the output file, or to stdout, for regression tracking.
+// -ui adds the frame time benchmarks of the views, which need a display (Xvfb will do).
+int main(int argc, char *argv[])
+{
+    bool ui = false;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "-ui"))
+            ui = true;
+    }
+    QScopedPointer<QCoreApplication> app(ui ? new QApplication(argc, argv) : new QCoreApplication(argc, argv));
+
+    QList<int> sizes;
+    sizes << 10000 << 100000 << 1000000;
+    int iterations = 5;
+    int frames = 200;
+    QString output;
+
+    foreach(const QString &arg, app->arguments().mid(1))
+    {
+        if(arg.startsWith("-sizes="))
+        {
+            sizes.clear();
+            foreach(const QString &size, arg.mid(7).split(',', QString::SkipEmptyParts))
+                sizes.append(size.toInt());
+        }
+        else if(arg.startsWith("-iterations="))
+            iterations = arg.mid(12).toInt();
+        else if(arg.startsWith("-frames="))
+            frames = arg.mid(8).toInt();
+        else if(arg.startsWith("-output="))
+            output = arg.mid(8);
+        else if(arg != "-ui")
+        {
+            std::cerr << USAGE;
+            return 1;
+        }
+    }
+
+    BenchRunner runner(iterations);
+    foreach(int size, sizes)
+    {
+        runModelBenchmarks(runner, size);
+        if(ui)
+            runUIBenchmarks(runner, size, frames);
+    }
+
+    if(!runner.writeReport(output.toStdString()))
+    {
+        std::cerr << "Could not write benchmark report\n";
+        return 1;
+    }
+    return 0;
+}
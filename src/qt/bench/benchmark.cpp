@@ -0,0 +1,184 @@
+#include "benchmark.h"
+
+#include <coinHTTP/RPC.h>
+
+#include <QElapsedTimer>
+
+#include <boost/atomic.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <cstdlib>
+
+// Count heap allocations by replacing the global allocation functions of the benchmark binary.
+// Benchmarked code allocates from QtConcurrent and node threads as well, so the counter is atomic.
+static boost::atomic<qint64> nAllocations(0);
+
+void *operator new(std::size_t size) throw(std::bad_alloc)
+{
+    nAllocations.fetch_add(1, boost::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](std::size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    std::free(p);
+}
+
+qint64 BenchRunner::allocations()
+{
+    return nAllocations.load();
+}
+
+// Upper bounds of the latency histogram buckets in microseconds, around the 16.7ms budget of a
+// frame at 60Hz. The last bucket holds everything slower.
+static const qint64 HISTOGRAM_BUCKETS[] = { 1000, 2000, 4000, 8000, 16667, 33333, 66667 };
+static const int NUM_HISTOGRAM_BUCKETS = sizeof(HISTOGRAM_BUCKETS) / sizeof(HISTOGRAM_BUCKETS[0]) + 1;
+
+BenchRunner::BenchRunner(int iterations):
+    iterations(std::max(iterations, 1))
+{
+}
+
+void BenchRunner::setIterations(int iterations)
+{
+    this->iterations = std::max(iterations, 1);
+}
+
+void BenchRunner::setCounter(const std::string &name, boost::function<qint64()> counter)
+{
+    this->counterName = counter ? name : std::string();
+    this->counter = counter;
+}
+
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+void BenchRunner::run(const std::string &name, qint64 size, qint64 ops, boost::function<void()> f,
+                      boost::function<void()> setup)
+{
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+    qint64 totalNsecs = 0;
+    qint64 totalAllocations = 0;
+    qint64 totalCount = 0;
+    qint64 maxCount = 0;
+    std::vector<int> histogram(NUM_HISTOGRAM_BUCKETS, 0);
+
+    for(int i = 0; i < iterations; ++i)
+    {
+        if(setup)
+            setup();
+        qint64 countBefore = counter ? counter() : 0;
+        qint64 allocationsBefore = nAllocations.load();
+        QElapsedTimer timer;
+        timer.start();
+        f();
+        qint64 nsecs = timer.nsecsElapsed();
+        totalAllocations += nAllocations.load() - allocationsBefore;
+        totalNsecs += nsecs;
+        latencies.push_back(nsecs / 1000.0);
+
+        int bucket = 0;
+        while(bucket < NUM_HISTOGRAM_BUCKETS - 1 && nsecs / 1000 >= HISTOGRAM_BUCKETS[bucket])
+            ++bucket;
+        ++histogram[bucket];
+
+        if(counter)
+        {
+            qint64 count = counter() - countBefore;
+            totalCount += count;
+            maxCount = std::max(maxCount, count);
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    Result result;
+    result.name = name;
+    result.size = size;
+    result.ops = ops;
+    result.opsPerSec = totalNsecs > 0 ? (double)ops * iterations * 1e9 / totalNsecs : 0;
+    result.p50 = percentile(latencies, 0.50);
+    result.p90 = percentile(latencies, 0.90);
+    result.p99 = percentile(latencies, 0.99);
+    result.max = latencies.back();
+    result.allocationsPerIteration = (double)totalAllocations / iterations;
+    result.histogram = histogram;
+    result.counterName = counterName;
+    result.counterMean = (double)totalCount / iterations;
+    result.counterMax = maxCount;
+    results.push_back(result);
+
+    std::cerr << name << " size=" << size << " " << (qint64)result.opsPerSec << " ops/s p50="
+              << result.p50 << "us\n";
+}
+
+bool BenchRunner::writeReport(const std::string &filename) const
+{
+    using namespace json_spirit;
+
+    Array benchmarks;
+    for(std::vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+    {
+        Object bench;
+        bench.push_back(Pair("name", it->name));
+        bench.push_back(Pair("size", (boost::int64_t)it->size));
+        bench.push_back(Pair("ops", (boost::int64_t)it->ops));
+        bench.push_back(Pair("ops_per_sec", it->opsPerSec));
+        bench.push_back(Pair("p50_us", it->p50));
+        bench.push_back(Pair("p90_us", it->p90));
+        bench.push_back(Pair("p99_us", it->p99));
+        bench.push_back(Pair("max_us", it->max));
+        bench.push_back(Pair("allocations_per_iteration", it->allocationsPerIteration));
+
+        Array histogram;
+        for(int i = 0; i < NUM_HISTOGRAM_BUCKETS; ++i)
+        {
+            Object bucket;
+            bucket.push_back(Pair("below_us", i < NUM_HISTOGRAM_BUCKETS - 1 ? Value((boost::int64_t)HISTOGRAM_BUCKETS[i]) : Value()));
+            bucket.push_back(Pair("count", it->histogram[i]));
+            histogram.push_back(bucket);
+        }
+        bench.push_back(Pair("histogram", histogram));
+
+        if(!it->counterName.empty())
+        {
+            bench.push_back(Pair(it->counterName + "_mean", it->counterMean));
+            bench.push_back(Pair(it->counterName + "_max", (boost::int64_t)it->counterMax));
+        }
+        benchmarks.push_back(bench);
+    }
+
+    Object root;
+    root.push_back(Pair("iterations", iterations));
+    root.push_back(Pair("benchmarks", benchmarks));
+
+    if(filename.empty())
+    {
+        std::cout << write_formatted(root) << "\n";
+        return std::cout.good();
+    }
+    std::ofstream file(filename.c_str());
+    if(!file)
+        return false;
+    file << write_formatted(root) << "\n";
+    return file.good();
+}
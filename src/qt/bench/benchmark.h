@@ -0,0 +1,67 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QtGlobal>
+
+#include <boost/function.hpp>
+
+#include <string>
+#include <vector>
+
+/** Runs named benchmarks a fixed number of times and collects, per benchmark, the throughput,
+    latency percentiles and histogram of a single iteration, and the number of heap allocations
+    per iteration. For UI benchmarks an iteration is one frame.
+ */
+class BenchRunner
+{
+public:
+    explicit BenchRunner(int iterations);
+
+    int getIterations() const { return iterations; }
+    void setIterations(int iterations);
+
+    /** Report the increase of counter over each iteration of the following benchmarks as name,
+        for instance the number of model data() calls per frame. An empty counter clears it.
+     */
+    void setCounter(const std::string &name, boost::function<qint64()> counter);
+
+    /** Run f iterations times. size is the size of the synthetic data set and ops the number of
+        operations done by one call of f, used for the ops/s figure.
+        setup, if given, is called before every iteration and is not measured.
+     */
+    void run(const std::string &name, qint64 size, qint64 ops, boost::function<void()> f,
+             boost::function<void()> setup = boost::function<void()>());
+
+    /** Write all results as JSON, to stdout if filename is empty. */
+    bool writeReport(const std::string &filename) const;
+
+    /** Number of heap allocations made by the process so far */
+    static qint64 allocations();
+
+private:
+    struct Result
+    {
+        std::string name;
+        qint64 size;
+        qint64 ops;
+        double opsPerSec;
+        // Latency of a single iteration, in microseconds
+        double p50;
+        double p90;
+        double p99;
+        double max;
+        double allocationsPerIteration;
+        // Number of iterations per latency bucket, see HISTOGRAM_BUCKETS
+        std::vector<int> histogram;
+        std::string counterName;
+        double counterMean;
+        qint64 counterMax;
+    };
+
+    int iterations;
+    std::string counterName;
+    boost::function<qint64()> counter;
+    std::vector<Result> results;
+};
+
+#endif // BENCHMARK_H
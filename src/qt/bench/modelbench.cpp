@@ -0,0 +1,262 @@
+#include "modelbench.h"
+#include "benchmark.h"
+#include "syntheticwallet.h"
+
+#include "transactiontablemodel.h"
+#include "transactionfilterproxy.h"
+#include "addresstablemodel.h"
+#include "csvmodelwriter.h"
+#include "bitcoinunits.h"
+#include "addresschecker.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+#include <boost/bind.hpp>
+
+// Transactions in each scripted block of the update benchmark
+static const int BLOCK_TRANSACTIONS = 100;
+
+static void newTableModel(SyntheticWallet *wallet, TransactionTableModel **model)
+{
+    delete *model;
+    *model = new TransactionTableModel(wallet);
+}
+
+static void populate(TransactionTableModel **model)
+{
+    (*model)->populate();
+}
+
+static void addBlock(SyntheticWallet *wallet, TransactionTableModel *model)
+{
+    model->updateTransactions(wallet->addBlock(BLOCK_TRANSACTIONS));
+}
+
+static void readStatus(TransactionTableModel *model)
+{
+    // A block came in since the last read, so every row updates its status
+    int rows = model->rowCount(QModelIndex());
+    for(int row = 0; row < rows; ++row)
+        model->index(row, TransactionTableModel::Status).data(Qt::EditRole);
+}
+
+static void refreshAddressBook(AddressTableModel *model)
+{
+    model->updateList();
+}
+
+static void newAddressBook(SyntheticWallet **wallet, AddressTableModel **model)
+{
+    delete *model;
+    delete *wallet;
+    *wallet = new SyntheticWallet(0);
+    *model = new AddressTableModel(*wallet);
+}
+
+static void importAddresses(AddressTableModel **model, const QList<WalletInterface::AddressBookEntry> *entries)
+{
+    (*model)->importAddresses(*entries);
+}
+
+static void lookupAddresses(AddressTableModel *model, const QStringList *addresses)
+{
+    foreach(const QString &address, *addresses)
+        model->lookupAddress(address);
+}
+
+static void formatAmounts(const QList<qint64> *amounts)
+{
+    foreach(qint64 amount, *amounts)
+        BitcoinUnits::format(BitcoinUnits::BTC, amount, true);
+}
+
+static void parseAmounts(const QStringList *formatted)
+{
+    qint64 amount;
+    foreach(const QString &str, *formatted)
+        BitcoinUnits::parse(BitcoinUnits::BTC, str, &amount);
+}
+
+static void formatAmountsBuffer(const QList<qint64> *amounts)
+{
+    QChar buf[BitcoinUnits::MAX_FORMAT_LENGTH];
+    foreach(qint64 amount, *amounts)
+        BitcoinUnits::format(BitcoinUnits::BTC, amount, true, buf);
+}
+
+static void parseAmountsBuffer(const QStringList *formatted)
+{
+    qint64 amount;
+    foreach(const QString &str, *formatted)
+        BitcoinUnits::parse(BitcoinUnits::BTC, str.constData(), str.size(), &amount);
+}
+
+// BitcoinUnits::format and parse as they were before the buffer kernels, as the baseline
+// for units.format and units.parse
+static QString legacyFormat(qint64 n, bool fPlus)
+{
+    qint64 coin = 100000000;
+    int num_decimals = 8;
+    qint64 n_abs = (n > 0 ? n : -n);
+    QString quotient_str = QString::number(n_abs / coin);
+    QString remainder_str = QString::number(n_abs % coin).rightJustified(num_decimals, '0');
+    int nTrim = 0;
+    for (int i = remainder_str.size()-1; i>=2 && (remainder_str.at(i) == '0'); --i)
+        ++nTrim;
+    remainder_str.chop(nTrim);
+    if (n < 0)
+        quotient_str.insert(0, '-');
+    else if (fPlus && n > 0)
+        quotient_str.insert(0, '+');
+    return quotient_str + QString(".") + remainder_str;
+}
+
+static bool legacyParse(const QString &value, qint64 *val_out)
+{
+    QStringList parts = value.split(".");
+    if(parts.size() > 2)
+        return false;
+    QString decimals = parts.size() > 1 ? parts[1] : QString();
+    if(decimals.size() > 8)
+        return false;
+    bool ok = false;
+    QString str = parts[0] + decimals.leftJustified(8, '0');
+    if(str.size() > 18)
+        return false;
+    *val_out = str.toLongLong(&ok);
+    return ok;
+}
+
+static void formatAmountsLegacy(const QList<qint64> *amounts)
+{
+    foreach(qint64 amount, *amounts)
+        legacyFormat(amount, true);
+}
+
+static void parseAmountsLegacy(const QStringList *formatted)
+{
+    qint64 amount;
+    foreach(const QString &str, *formatted)
+        legacyParse(str, &amount);
+}
+
+static void checkAddresses(const QStringList *addresses)
+{
+    foreach(const QString &address, *addresses)
+        AddressChecker::check(address, 0);
+}
+
+static void checkAddressesBatch(const QStringList *addresses)
+{
+    AddressChecker::checkBatch(*addresses, 0);
+}
+
+static void filterAddress(TransactionFilterProxy *proxy, int *round)
+{
+    // Alternate the prefix so that every iteration has to filter again
+    proxy->setAddressPrefix((*round)++ % 2 ? "1a" : "Contact 1");
+    proxy->rowCount();
+}
+
+static void filterType(TransactionFilterProxy *proxy, int *round)
+{
+    proxy->setTypeFilter((*round)++ % 2 ? TransactionFilterProxy::TYPE(TransactionRecord::Generated) :
+                                          TransactionFilterProxy::ALL_TYPES);
+    proxy->rowCount();
+}
+
+static void sortAmount(TransactionFilterProxy *proxy, int *round)
+{
+    proxy->sort(TransactionTableModel::Amount, (*round)++ % 2 ? Qt::AscendingOrder : Qt::DescendingOrder);
+}
+
+static void exportCSV(TransactionFilterProxy *proxy, const QString &filename)
+{
+    // Same columns as TransactionView::exportClicked
+    CSVModelWriter writer(filename);
+    writer.setModel(proxy);
+    writer.addColumn("Confirmed", 0, TransactionTableModel::ConfirmedRole);
+    writer.addColumn("Date", 0, TransactionTableModel::DateRole);
+    writer.addColumn("Type", TransactionTableModel::Type, Qt::EditRole);
+    writer.addColumn("Label", 0, TransactionTableModel::LabelRole);
+    writer.addColumn("Address", 0, TransactionTableModel::AddressRole);
+    writer.addColumn("Amount", 0, TransactionTableModel::FormattedAmountRole);
+    writer.addColumn("ID", 0, TransactionTableModel::TxIDRole);
+    writer.write();
+}
+
+void runModelBenchmarks(BenchRunner &runner, int size)
+{
+    SyntheticWallet wallet(size);
+
+    // Fill a new model from the wallet every iteration
+    TransactionTableModel *model = 0;
+    runner.run("ttm.refreshWallet", size, size, boost::bind(populate, &model),
+               boost::bind(newTableModel, &wallet, &model));
+
+    runner.run("ttm.updateWallet", size, BLOCK_TRANSACTIONS, boost::bind(addBlock, &wallet, model));
+    runner.run("ttm.updateStatus", size, model->rowCount(QModelIndex()), boost::bind(readStatus, model),
+               boost::bind(addBlock, &wallet, model));
+
+    AddressTableModel addressModel(&wallet);
+    runner.run("atm.refresh", size, addressModel.rowCount(QModelIndex()), boost::bind(refreshAddressBook, &addressModel));
+
+    // Import size new addresses into a fresh address book every iteration
+    QList<WalletInterface::AddressBookEntry> importEntries;
+    for(int i = 0; i < size; ++i)
+    {
+        unsigned char hash160[20] = {};
+        for(int j = 0; j < 4; ++j)
+            hash160[j] = (unsigned char)(i >> (8 * j));
+        importEntries.append(WalletInterface::AddressBookEntry(AddressChecker::encode(0, hash160),
+                                                               QString("Merchant %1").arg(i), false));
+    }
+    SyntheticWallet *importWallet = 0;
+    AddressTableModel *importModel = 0;
+    runner.run("atm.import", size, importEntries.size(), boost::bind(importAddresses, &importModel, &importEntries),
+               boost::bind(newAddressBook, &importWallet, &importModel));
+    delete importModel;
+    delete importWallet;
+
+    QList<qint64> amounts;
+    QStringList formatted;
+    QStringList addresses;
+    for(int row = 0; row < model->rowCount(QModelIndex()); ++row)
+    {
+        QModelIndex index = model->index(row, 0);
+        qint64 amount = index.data(TransactionTableModel::AmountRole).toLongLong();
+        amounts.append(amount);
+        formatted.append(BitcoinUnits::format(BitcoinUnits::BTC, amount));
+        addresses.append(index.data(TransactionTableModel::AddressRole).toString());
+    }
+    runner.run("atm.lookup", size, addresses.size(), boost::bind(lookupAddresses, &addressModel, &addresses));
+    runner.run("address.check", size, addresses.size(), boost::bind(checkAddresses, &addresses));
+    runner.run("address.checkBatch", size, addresses.size(), boost::bind(checkAddressesBatch, &addresses));
+    runner.run("units.format.legacy", size, amounts.size(), boost::bind(formatAmountsLegacy, &amounts));
+    runner.run("units.format", size, amounts.size(), boost::bind(formatAmounts, &amounts));
+    runner.run("units.format.buffer", size, amounts.size(), boost::bind(formatAmountsBuffer, &amounts));
+    runner.run("units.parse.legacy", size, formatted.size(), boost::bind(parseAmountsLegacy, &formatted));
+    runner.run("units.parse", size, formatted.size(), boost::bind(parseAmounts, &formatted));
+    runner.run("units.parse.buffer", size, formatted.size(), boost::bind(parseAmountsBuffer, &formatted));
+
+    // Proxy set up like in TransactionView
+    TransactionFilterProxy proxy;
+    proxy.setSourceModel(model);
+    proxy.setDynamicSortFilter(true);
+    proxy.setSortRole(Qt::EditRole);
+
+    int round = 0;
+    runner.run("filter.address", size, size, boost::bind(filterAddress, &proxy, &round));
+    proxy.setAddressPrefix(QString());
+    runner.run("filter.type", size, size, boost::bind(filterType, &proxy, &round));
+    proxy.setTypeFilter(TransactionFilterProxy::ALL_TYPES);
+    runner.run("sort.amount", size, size, boost::bind(sortAmount, &proxy, &round));
+
+    QString filename = QDir::temp().filePath("bitcoin-qt_bench.csv");
+    runner.run("csv.export", size, size, boost::bind(exportCSV, &proxy, filename));
+    QFile::remove(filename);
+
+    delete model;
+}
@@ -0,0 +1,11 @@
+#ifndef MODELBENCH_H
+#define MODELBENCH_H
+
+class BenchRunner;
+
+/** Benchmarks of TransactionTableModel, AddressTableModel, TransactionFilterProxy, CSVModelWriter and
+    BitcoinUnits on a synthetic wallet of size transactions.
+ */
+void runModelBenchmarks(BenchRunner &runner, int size);
+
+#endif // MODELBENCH_H
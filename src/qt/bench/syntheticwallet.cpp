@@ -0,0 +1,302 @@
+#include "syntheticwallet.h"
+#include "addresschecker.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+// Average number of transactions per block of the generated history
+static const int TRANSACTIONS_PER_BLOCK = 4;
+// Blocks needed for generated coins to mature
+static const int COINBASE_MATURITY = 100;
+
+SyntheticWallet::SyntheticWallet(int numTransactions, int numAddresses, quint32 seed):
+    bestHeight(0), nextTime(QDateTime(QDate(2009, 1, 3)).toTime_t()), counter(0), state(seed)
+{
+    for(int i = 0; i < numAddresses; ++i)
+    {
+        QString address = randomAddress();
+        addresses.append(address);
+        // A quarter of the addresses are our own receiving addresses, a third is labeled
+        if(i % 4 == 0)
+            ownAddresses.insert(address);
+        addressBook.insert(address, AddressBookEntry(address, i % 3 == 0 ? QString("Contact %1").arg(i) : QString(), i % 4 == 0));
+    }
+
+    bestHeight = numTransactions / TRANSACTIONS_PER_BLOCK + 1;
+    for(int height = 0; height <= bestHeight; ++height)
+        addBlockHash();
+    for(int i = 0; i < numTransactions; ++i)
+        addTransaction(1 + i / TRANSACTIONS_PER_BLOCK);
+}
+
+// Small deterministic generator, so that runs are comparable between builds and platforms
+quint32 SyntheticWallet::nextRandom()
+{
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+QString SyntheticWallet::randomAddress()
+{
+    unsigned char hash160[20];
+    for(int j = 0; j < 20; ++j)
+        hash160[j] = nextRandom() & 0xff;
+    return AddressChecker::encode(0, hash160);
+}
+
+uint256 SyntheticWallet::addTransaction(int height)
+{
+    // Scatter the hashes, so that new transactions are inserted all over the model and not only at the end
+    quint64 mixed = (++counter) * 0x9E3779B97F4A7C15ULL;
+    uint256 hash = (uint256(mixed) << 192) | uint256(counter);
+
+    Tx tx;
+    tx.type = (TransactionRecord::Type)(TransactionRecord::Generated + nextRandom() % TransactionRecord::SendToSelf);
+    nextTime += nextRandom() % 600;
+    tx.time = nextTime;
+    tx.address = addresses.isEmpty() ? QString() : addresses[nextRandom() % addresses.size()];
+    tx.amount = (qint64)(nextRandom() % 10000000) * 1000;
+    if(tx.type == TransactionRecord::SendToAddress || tx.type == TransactionRecord::SendToOther)
+        tx.amount = -tx.amount;
+    tx.height = height;
+    transactions.insert(std::make_pair(hash, tx));
+    return hash;
+}
+
+void SyntheticWallet::addBlockHash()
+{
+    // Tagged in the top byte, so that block hashes never collide with transaction hashes
+    blockHashes.push_back((uint256(0xb1) << 248) | uint256(++counter));
+}
+
+QList<uint256> SyntheticWallet::addBlock(int numTransactions)
+{
+    ++bestHeight;
+    addBlockHash();
+    QList<uint256> added;
+    for(int i = 0; i < numTransactions; ++i)
+        added.append(addTransaction(bestHeight));
+    return added;
+}
+
+QList<uint256> SyntheticWallet::addTransactions(int numTransactions)
+{
+    QList<uint256> added;
+    for(int i = 0; i < numTransactions; ++i)
+        added.append(addTransaction(-1));
+    return added;
+}
+
+void SyntheticWallet::removeTransaction(const uint256 &hash)
+{
+    transactions.erase(hash);
+}
+
+QList<uint256> SyntheticWallet::confirmTransactions()
+{
+    ++bestHeight;
+    addBlockHash();
+    QList<uint256> confirmed;
+    for(std::map<uint256, Tx>::iterator it = transactions.begin(); it != transactions.end(); ++it)
+    {
+        if(it->second.height < 0)
+        {
+            it->second.height = bestHeight;
+            confirmed.append(it->first);
+        }
+    }
+    return confirmed;
+}
+
+QList<uint256> SyntheticWallet::reorganize(int depth)
+{
+    depth = std::min(depth, bestHeight);
+    int forkHeight = bestHeight - depth;
+    blockHashes.resize(forkHeight + 1);
+    for(int i = 0; i < depth; ++i)
+        addBlockHash();
+
+    QList<uint256> unconfirmed;
+    for(std::map<uint256, Tx>::iterator it = transactions.begin(); it != transactions.end(); ++it)
+    {
+        if(it->second.height > forkHeight)
+        {
+            it->second.height = -1;
+            unconfirmed.append(it->first);
+        }
+    }
+    return unconfirmed;
+}
+
+TransactionRecord SyntheticWallet::toRecord(const uint256 &hash, const Tx &tx) const
+{
+    return TransactionRecord(hash, tx.time, tx.type, tx.address.toStdString(),
+                             tx.amount < 0 ? tx.amount : 0, tx.amount > 0 ? tx.amount : 0);
+}
+
+QList<TransactionRecord> SyntheticWallet::getTransactionRecords()
+{
+    QList<TransactionRecord> records;
+    records.reserve(transactions.size());
+    for(std::map<uint256, Tx>::const_iterator it = transactions.begin(); it != transactions.end(); ++it)
+        records.append(toRecord(it->first, it->second));
+    return records;
+}
+
+bool SyntheticWallet::haveTransaction(const uint256 &hash)
+{
+    return transactions.count(hash) != 0;
+}
+
+QList<TransactionRecord> SyntheticWallet::getTransactionRecords(const uint256 &hash)
+{
+    QList<TransactionRecord> records;
+    std::map<uint256, Tx>::const_iterator mi = transactions.find(hash);
+    if(mi != transactions.end())
+        records.append(toRecord(mi->first, mi->second));
+    return records;
+}
+
+void SyntheticWallet::updateStatus(TransactionRecord &rec)
+{
+    std::map<uint256, Tx>::const_iterator mi = transactions.find(rec.hash);
+    if(mi == transactions.end())
+        return;
+    const Tx &tx = mi->second;
+
+    TransactionStatus &status = rec.status;
+    int height = tx.height < 0 ? 999999999 : tx.height;
+    status.sortKey = QString("%1-%2-%3").arg(height, 10, 10, QChar('0'))
+            .arg((qint64)tx.time, 10, 10, QChar('0')).arg(rec.idx, 3, 10, QChar('0')).toStdString();
+    status.depth = tx.height < 0 ? 0 : bestHeight - tx.height + 1;
+    status.cur_num_blocks = bestHeight;
+    status.confirmed = status.depth > 0;
+    status.status = status.depth < TransactionRecord::NumConfirmations ?
+                TransactionStatus::Unconfirmed : TransactionStatus::HaveConfirmations;
+    if(rec.type == TransactionRecord::Generated)
+    {
+        status.matures_in = std::max(0, COINBASE_MATURITY + 1 - (int)status.depth);
+        status.maturity = status.matures_in > 0 ? TransactionStatus::Immature : TransactionStatus::Mature;
+    }
+}
+
+QString SyntheticWallet::describeTransaction(const TransactionRecord &rec)
+{
+    return QString("<html><b>Transaction ID:</b> %1<br><b>Address:</b> %2</html>")
+            .arg(QString::fromStdString(rec.hash.GetHex()), QString::fromStdString(rec.address));
+}
+
+int SyntheticWallet::getBestHeight()
+{
+    return bestHeight;
+}
+
+QList<WalletInterface::AddressBookEntry> SyntheticWallet::getAddressBook()
+{
+    return addressBook.values();
+}
+
+bool SyntheticWallet::haveAddressBookEntry(const QString &address)
+{
+    return addressBook.contains(address);
+}
+
+bool SyntheticWallet::isMine(const QString &address)
+{
+    return ownAddresses.contains(address);
+}
+
+QString SyntheticWallet::labelForAddress(const QString &address)
+{
+    QMap<QString, AddressBookEntry>::const_iterator mi = addressBook.find(address);
+    return mi != addressBook.end() ? mi->label : QString();
+}
+
+void SyntheticWallet::setAddressBookName(const QString &address, const QString &label)
+{
+    QMap<QString, AddressBookEntry>::iterator mi = addressBook.find(address);
+    if(mi != addressBook.end())
+        mi->label = label;
+    else
+        addressBook.insert(address, AddressBookEntry(address, label, isMine(address)));
+}
+
+bool SyntheticWallet::setAddressBookNames(const QList<AddressBookEntry> &entries)
+{
+    foreach(const AddressBookEntry &entry, entries)
+        setAddressBookName(entry.address, entry.label);
+    return true;
+}
+
+void SyntheticWallet::delAddressBookName(const QString &address)
+{
+    addressBook.remove(address);
+}
+
+void SyntheticWallet::changeAddress(const QString &oldAddress, const QString &newAddress, const QString &label)
+{
+    addressBook.remove(oldAddress);
+    addressBook.insert(newAddress, AddressBookEntry(newAddress, label, isMine(newAddress)));
+}
+
+bool SyntheticWallet::getNewAddress(QString &address)
+{
+    address = randomAddress();
+    ownAddresses.insert(address);
+    addressBook.insert(address, AddressBookEntry(address, QString(), true));
+    return true;
+}
+
+std::vector<uint256> SyntheticWallet::getTransactions()
+{
+    std::vector<uint256> hashes;
+    hashes.reserve(transactions.size());
+    for(std::map<uint256, Tx>::const_iterator it = transactions.begin(); it != transactions.end(); ++it)
+        hashes.push_back(it->first);
+    return hashes;
+}
+
+bool SyntheticWallet::getTxBalance(const uint256 &hash, TxBalance &balance)
+{
+    std::map<uint256, Tx>::const_iterator mi = transactions.find(hash);
+    if(mi == transactions.end())
+        return false;
+    const Tx &tx = mi->second;
+    // Same classification as the core wallet: generated coins are immature until they have
+    // COINBASE_MATURITY confirmations and do not count while unconfirmed
+    if(tx.type == TransactionRecord::Generated && (tx.height < 0 || bestHeight - tx.height + 1 <= COINBASE_MATURITY))
+    {
+        if(tx.height >= 0)
+            balance.immature = tx.amount;
+        balance.pending = true;
+    }
+    else if(tx.height >= 0)
+    {
+        balance.confirmed = tx.amount;
+    }
+    else
+    {
+        balance.unconfirmed = tx.amount;
+        balance.pending = true;
+    }
+    return true;
+}
+
+std::vector<uint256> SyntheticWallet::getSpentTransactions(const uint256 &hash)
+{
+    // Generated transactions have no inputs
+    Q_UNUSED(hash);
+    return std::vector<uint256>();
+}
+
+void SyntheticWallet::getBestBlock(int &height, uint256 &hash)
+{
+    height = bestHeight;
+    hash = blockHashes[bestHeight];
+}
+
+bool SyntheticWallet::isInBestChain(int height, const uint256 &hash)
+{
+    return height >= 0 && height <= bestHeight && blockHashes[height] == hash;
+}
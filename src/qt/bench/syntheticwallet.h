@@ -0,0 +1,96 @@
+#ifndef SYNTHETICWALLET_H
+#define SYNTHETICWALLET_H
+
+#include "walletinterface.h"
+#include "walletbalance.h"
+
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+
+#include <map>
+#include <vector>
+
+/** In-memory wallet with a deterministic, generated history, for running the table models
+    and balance totals offline in benchmarks and tests. Blocks can be scripted to arrive with
+    addBlock(), and to be replaced with reorganize().
+ */
+class SyntheticWallet : public WalletInterface, public BalanceSource
+{
+public:
+    /** Generate numTransactions transactions spread over the blocks up to the initial height,
+        involving numAddresses address book entries.
+     */
+    SyntheticWallet(int numTransactions, int numAddresses = 1000, quint32 seed = 42);
+
+    /** Add a block with numTransactions new transactions. Returns the hashes of the added transactions,
+        to pass to TransactionTableModel::updateTransactions.
+     */
+    QList<uint256> addBlock(int numTransactions);
+    /** Add numTransactions unconfirmed transactions */
+    QList<uint256> addTransactions(int numTransactions);
+    /** Drop a transaction, as if it was double spent */
+    void removeTransaction(const uint256 &hash);
+    /** Add a block with the unconfirmed transactions. Returns their hashes. */
+    QList<uint256> confirmTransactions();
+    /** Replace the last depth blocks by as many new blocks without transactions, so that the
+        transactions in them become unconfirmed. Returns the hashes of those transactions.
+     */
+    QList<uint256> reorganize(int depth);
+
+    int size() const { return (int)transactions.size(); }
+
+    QList<TransactionRecord> getTransactionRecords();
+    bool haveTransaction(const uint256 &hash);
+    QList<TransactionRecord> getTransactionRecords(const uint256 &hash);
+    void updateStatus(TransactionRecord &rec);
+    QString describeTransaction(const TransactionRecord &rec);
+    int getBestHeight();
+
+    QList<AddressBookEntry> getAddressBook();
+    bool haveAddressBookEntry(const QString &address);
+    bool isMine(const QString &address);
+    QString labelForAddress(const QString &address);
+    void setAddressBookName(const QString &address, const QString &label);
+    bool setAddressBookNames(const QList<AddressBookEntry> &entries);
+    void delAddressBookName(const QString &address);
+    void changeAddress(const QString &oldAddress, const QString &newAddress, const QString &label);
+    bool getNewAddress(QString &address);
+
+    std::vector<uint256> getTransactions();
+    bool getTxBalance(const uint256 &hash, TxBalance &balance);
+    std::vector<uint256> getSpentTransactions(const uint256 &hash);
+    void getBestBlock(int &height, uint256 &hash);
+    bool isInBestChain(int height, const uint256 &hash);
+
+private:
+    struct Tx
+    {
+        int64 time;
+        TransactionRecord::Type type;
+        QString address;
+        qint64 amount;
+        /** Height of the block containing the transaction, -1 if unconfirmed */
+        int height;
+    };
+
+    std::map<uint256, Tx> transactions;
+    QMap<QString, AddressBookEntry> addressBook;
+    QStringList addresses;
+    /** Addresses we have the key of, whether they are in the address book or not */
+    QSet<QString> ownAddresses;
+    /** Hash of the block at each height, up to bestHeight */
+    std::vector<uint256> blockHashes;
+    int bestHeight;
+    int64 nextTime;
+    quint64 counter;
+    quint32 state;
+
+    quint32 nextRandom();
+    QString randomAddress();
+    uint256 addTransaction(int height);
+    void addBlockHash();
+    TransactionRecord toRecord(const uint256 &hash, const Tx &tx) const;
+};
+
+#endif // SYNTHETICWALLET_H
@@ -0,0 +1,149 @@
+#include "uibench.h"
+#include "benchmark.h"
+#include "syntheticwallet.h"
+
+#include "transactiontablemodel.h"
+#include "transactionview.h"
+#include "overviewpage.h"
+
+#include <QApplication>
+#include <QHeaderView>
+#include <QImage>
+#include <QLineEdit>
+#include <QScrollBar>
+#include <QTableView>
+#include <QTest>
+
+#include <boost/bind.hpp>
+
+/** Table model that counts the calls of data(), the main cost of painting a view */
+class CountingTransactionTableModel : public TransactionTableModel
+{
+public:
+    explicit CountingTransactionTableModel(WalletInterface *wallet):
+        TransactionTableModel(wallet), calls(0) {}
+
+    QVariant data(const QModelIndex &index, int role) const
+    {
+        ++calls;
+        return TransactionTableModel::data(index, role);
+    }
+
+    qint64 getCalls() const { return calls; }
+
+private:
+    mutable qint64 calls;
+};
+
+// Paint the whole widget synchronously, like an expose of the window
+static void renderFrame(QWidget *widget, QImage *image)
+{
+    widget->render(image);
+}
+
+static void scrollFrame(QTableView *table, QWidget *widget, QImage *image)
+{
+    QScrollBar *bar = table->verticalScrollBar();
+    QTest::keyClick(table, bar->value() >= bar->maximum() ? Qt::Key_Home : Qt::Key_PageDown);
+    renderFrame(widget, image);
+}
+
+static void sortFrame(QTableView *table, QWidget *widget, QImage *image, int *round)
+{
+    static const int columns[] = { TransactionTableModel::Date, TransactionTableModel::Type,
+                                   TransactionTableModel::ToAddress, TransactionTableModel::Amount,
+                                   TransactionTableModel::Status };
+    QHeaderView *header = table->horizontalHeader();
+    int column = columns[(*round)++ % 5];
+    QTest::mouseClick(header->viewport(), Qt::LeftButton, 0,
+                      QPoint(header->sectionViewportPosition(column) + header->sectionSize(column) / 2, header->height() / 2));
+    renderFrame(widget, image);
+}
+
+static void resizeFrame(QWidget *widget, QImage *image, int *round)
+{
+    widget->resize((*round)++ % 2 ? 1000 : 760, 600);
+    // Apply the posted layout requests before painting
+    QApplication::sendPostedEvents();
+    renderFrame(widget, image);
+}
+
+static void filterFrame(QLineEdit *edit, QWidget *widget, QImage *image, int *round)
+{
+    // Type a prefix and erase it again, one key per frame
+    static const char typed[] = "1ab";
+    int step = (*round)++ % 6;
+    if(step < 3)
+        QTest::keyClick(edit, typed[step]);
+    else
+        QTest::keyClick(edit, Qt::Key_Backspace);
+    renderFrame(widget, image);
+}
+
+static void blockFrame(SyntheticWallet *wallet, TransactionTableModel *model, QWidget *widget, QImage *image)
+{
+    model->updateTransactions(wallet->addBlock(10));
+    renderFrame(widget, image);
+}
+
+static qint64 dataCalls(const CountingTransactionTableModel *model)
+{
+    return model->getCalls();
+}
+
+static void showOffscreen(QWidget *widget)
+{
+    // Lay out and paint like a visible window, without mapping it on the screen
+    widget->setAttribute(Qt::WA_DontShowOnScreen);
+    widget->resize(1000, 600);
+    widget->show();
+    QApplication::processEvents();
+}
+
+void runUIBenchmarks(BenchRunner &runner, int size, int frames)
+{
+    SyntheticWallet wallet(size);
+    CountingTransactionTableModel model(&wallet);
+    model.populate();
+
+    int savedIterations = runner.getIterations();
+    runner.setIterations(frames);
+    runner.setCounter("data_calls_per_frame", boost::bind(dataCalls, &model));
+
+    TransactionView view;
+    view.setTransactionModel(&model);
+    showOffscreen(&view);
+    QImage viewImage(view.size(), QImage::Format_ARGB32_Premultiplied);
+    QTableView *table = view.findChild<QTableView*>();
+    QLineEdit *addressEdit = 0;
+    foreach(QLineEdit *edit, view.findChildren<QLineEdit*>())
+    {
+        // The first line edit of the filter row is the address filter
+        if(edit->parentWidget() == &view)
+        {
+            addressEdit = edit;
+            break;
+        }
+    }
+
+    int round = 0;
+    runner.run("ui.transactions.scroll", size, 1, boost::bind(scrollFrame, table, &view, &viewImage));
+    runner.run("ui.transactions.sort", size, 1, boost::bind(sortFrame, table, &view, &viewImage, &round));
+    runner.run("ui.transactions.resize", size, 1, boost::bind(resizeFrame, &view, &viewImage, &round));
+    if(addressEdit)
+        runner.run("ui.transactions.filter", size, 1, boost::bind(filterFrame, addressEdit, &view, &viewImage, &round));
+    view.hide();
+    view.setTransactionModel(0);
+
+    OverviewPage overview;
+    overview.setTransactionModel(&model);
+    showOffscreen(&overview);
+    QImage overviewImage(overview.size(), QImage::Format_ARGB32_Premultiplied);
+
+    runner.run("ui.overview.block", size, 1, boost::bind(blockFrame, &wallet, &model, &overview, &overviewImage));
+    runner.run("ui.overview.resize", size, 1, boost::bind(resizeFrame, &overview, &overviewImage, &round));
+    overview.hide();
+
+    runner.setCounter(std::string(), boost::function<qint64()>());
+    runner.setIterations(savedIterations);
+}
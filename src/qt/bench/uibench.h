@@ -0,0 +1,12 @@
+#ifndef UIBENCH_H
+#define UIBENCH_H
+
+class BenchRunner;
+
+/** Frame time benchmarks of TransactionView and OverviewPage on a synthetic wallet of size transactions:
+    scrolling, sorting, resizing and filtering, driven with QTest events. Each frame renders the whole
+    widget, and the number of model data() calls per frame is reported. Needs a QApplication.
+ */
+void runUIBenchmarks(BenchRunner &runner, int size, int frames);
+
+#endif // UIBENCH_H
@@ -4,6 +4,14 @@
 #include "bitcoingui.h"
 #include "clientmodel.h"
 #include "walletmodel.h"
+#include "walletmanager.h"
+#include "walletrescanner.h"
+#include "keypoolrefiller.h"
+#include "deterministickeychain.h"
+#include "messagerpc.h"
+#include "memoryrpc.h"
+#include "startupprofiler.h"
+#include "batchclient.h"
 #include "optionsmodel.h"
 
 #include "qtipcserver.h"
@@ -16,6 +24,8 @@
 #include <QTranslator>
 #include <QSplashScreen>
 #include <QLibraryInfo>
+#include <QDateTime>
+#include <QTimer>
 
 #include <coinChain/Node.h>
 #include <coinChain/NodeRPC.h>
@@ -27,8 +37,11 @@
 #include <coinWallet/WalletRPC.h>
 
 #include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
-#include <boost/interprocess/ipc/message_queue.hpp>
+#include <boost/foreach.hpp>
 
 using namespace std;
 using namespace boost;
@@ -37,6 +50,7 @@ using namespace boost::program_options;
 // Need a global reference for the notifications to find the GUI
 BitcoinGUI *guiref;
 QSplashScreen *splashref;
+StartupProfiler *profilerref;
 /*
 int MyMessageBox(const std::string& message, const std::string& caption, int style, wxWindow* parent, int x, int y)
 {
@@ -136,44 +150,97 @@ std::string _(const char* psz)
     return QCoreApplication::translate("bitcoin-core", psz).toStdString();
 }
 
-#ifndef BITCOIN_QT_TEST
+/*
+   Start timing the next startup phase, and show it on the splash screen.
+ */
+static void StartupPhase(const char* psz)
+{
+    if(profilerref)
+        profilerref->beginPhase(psz);
+    InitMessage(_(psz));
+}
+
+/*
+   Register the node and wallet JSON-RPC methods with the server.
+   Methods that expose or spend wallet funds require authentication.
+ */
+static void registerRPCMethods(Server &server, Node &node, Wallet &wallet, const Auth &auth)
+{
+    // Server methods
+    server.registerMethod(method_ptr(new Stop(server)), auth);
+
+    // Node methods
+    server.registerMethod(method_ptr(new GetBlockCount(node)));
+    server.registerMethod(method_ptr(new GetConnectionCount(node)));
+    server.registerMethod(method_ptr(new GetDifficulty(node)));
+    server.registerMethod(method_ptr(new GetInfo(node)));
+
+    // Wallet methods
+    server.registerMethod(method_ptr(new GetBalance(wallet)), auth);
+    server.registerMethod(method_ptr(new GetNewAddress(wallet)), auth);
+    server.registerMethod(method_ptr(new SendToAddress(wallet)), auth);
+    server.registerMethod(method_ptr(new GetAccountAddress(wallet)), auth);
+    server.registerMethod(method_ptr(new GetAccount(wallet)), auth);
+    server.registerMethod(method_ptr(new SetAccount(wallet)), auth);
+    server.registerMethod(method_ptr(new GetAddressesByAccount(wallet)), auth);
+    server.registerMethod(method_ptr(new ListTransactions(wallet)), auth);
+    server.registerMethod(method_ptr(new GetTransaction(wallet)), auth);
+    server.registerMethod(method_ptr(new SignMessages(wallet)), auth);
+    server.registerMethod(method_ptr(new VerifyMessages(wallet)));
+    server.registerMethod(method_ptr(new GetMemoryUsage(node, wallet)), auth);
+}
+
+/*
+   Serve JSON-RPC requests from a pool of threads sharing the io_service of the server,
+   so that a slow call does not hold up the others. Returns once the server is stopped.
+ */
+static void serveRPC(Server *server, int threads)
+{
+    thread_group workers;
+    for(int i = 1; i < threads; ++i)
+        workers.create_thread(boost::bind(&Server::run, server));
+    server->run();
+    workers.join_all();
+
+    // A "stop" command quits the GUI as well
+    if(QCoreApplication::instance())
+        QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+}
+
+#if !defined(BITCOIN_QT_TEST) && !defined(BITCOIN_QT_BENCH)
 int main(int argc, char *argv[])
 {
-    // Do this early as we don't want to bother initializing if we are just calling IPC
-    for (int i = 1; i < argc; i++)
-    {
-        if (strlen(argv[i]) > 7 && strncasecmp(argv[i], "bitcoin:", 8) == 0)
-        {
-            const char *strURL = argv[i];
-            try {
-                boost::interprocess::message_queue mq(boost::interprocess::open_only, "BitcoinURL");
-                if(mq.try_send(strURL, strlen(strURL), 0))
-                    exit(0);
-                else
-                    break;
-            }
-            catch (boost::interprocess::interprocess_exception &ex) {
-                break;
-            }
-        }
-    }
+    // Do this early as we don't want to bother initializing if we are just calling IPC.
+    // The URIs are taken out of the arguments, the rest are options for this instance only.
+    QStringList urls = IPCServer::takeURLsFromArguments(argc, argv);
+    if (!urls.isEmpty() && IPCServer::sendToRunningInstance(urls))
+        return 0;
 
     // Internal string conversion is all UTF-8
     QTextCodec::setCodecForTr(QTextCodec::codecForName("UTF-8"));
     QTextCodec::setCodecForCStrings(QTextCodec::codecForTr());
 
-    Q_INIT_RESOURCE(bitcoin);
-    QApplication app(argc, argv);
+    StartupProfiler profiler;
+    profilerref = &profiler;
+    StartupPhase("Parsing configuration...");
 
     string config_file, data_dir, locale;
     unsigned short rpc_port;
+    int rpc_threads;
     string rpc_bind, rpc_connect, rpc_user, rpc_pass;
     typedef vector<string> strings;
     strings rpc_params;
     strings connect_peers;
     strings add_peers;
+    strings wallet_files;
+    int rescan_height;
+    unsigned short keypool_size;
+    string rescan_date;
     bool gen, ssl;
     string certchain, privkey;
+    string startup_profile;
+    string batch_file;
+    int batch_size, rpc_concurrency;
 
     // Commandline options
     options_description generic("Generic options");
@@ -182,6 +249,13 @@ int main(int argc, char *argv[])
         ("version,v", "print version string")
         ("conf,c", value<string>(&config_file)->default_value("bitcoin.conf"), "Specify configuration file")
         ("datadir", "Specify non default data directory")
+        ("daemon", "Run headless and accept JSON-RPC commands, without starting the GUI")
+        ("server", "Same as -daemon")
+        ("startupprofile", value<string>(&startup_profile), "Write the time and memory used by each startup phase to <arg> as JSON")
+        ("batch", "Read RPC commands from stdin, one per line, and send them to a running instance in batches")
+        ("batchfile", value<string>(&batch_file), "Read RPC commands from file <arg> instead of stdin")
+        ("batchsize", value<int>(&batch_size)->default_value(100), "Number of RPC commands per batch")
+        ("rpcconcurrency", value<int>(&rpc_concurrency)->default_value(1), "Number of batches in flight at the same time")
     ;
 
     options_description config("Config options");
@@ -194,10 +268,16 @@ int main(int argc, char *argv[])
         ("rpcuser", value<string>(&rpc_user), "Username for JSON-RPC connections")
         ("rpcpassword", value<string>(&rpc_pass), "Password for JSON-RPC connections")
         ("rpcport", value<unsigned short>(&rpc_port)->default_value(8332), "Listen for JSON-RPC connections on <arg>")
+        ("rpcserver", "Accept JSON-RPC commands while the GUI is running")
+        ("rpcthreads", value<int>(&rpc_threads)->default_value(4), "Number of threads serving JSON-RPC requests")
         ("rpcallowip", value<string>(&rpc_bind)->default_value(asio::ip::address_v4::loopback().to_string()), "Allow JSON-RPC connections from specified IP address")
         ("rpcconnect", value<string>(&rpc_connect)->default_value(asio::ip::address_v4::loopback().to_string()), "Send commands to node running on <arg>")
-        ("keypool", value<unsigned short>(), "Set key pool size to <arg>")
-        ("rescan", "Rescan the block chain for missing wallet transactions")
+        ("wallet", value<strings>(&wallet_files), "Also attach wallet file <arg> in the data directory, loaded when first selected")
+        ("deterministic", "Derive the GUI receiving addresses of new wallets from a seed, so that one backup covers them (change keys still come from the key pool)")
+        ("keypool", value<unsigned short>(&keypool_size)->default_value(KeyPoolRefiller::DEFAULT_TARGET_SIZE), "Set key pool size to <arg>")
+        ("rescan", "Rescan the block chain for missing wallet transactions, from the wallet creation time if known")
+        ("rescanheight", value<int>(&rescan_height), "Rescan the block chain from block height <arg>")
+        ("rescandate", value<string>(&rescan_date), "Rescan the block chain from the date <arg> (YYYY-MM-DD)")
         ("gen", value<bool>(&gen)->default_value(false), "Generate coins")
         ("rpcssl", value<bool>(&ssl)->default_value(false), "Use OpenSSL (https) for JSON-RPC connections")
         ("rpcsslcertificatechainfile", value<string>(&certchain)->default_value("server.cert"), "Server certificate file")
@@ -254,12 +334,24 @@ int main(int argc, char *argv[])
 
     try {
         // If we have params on the cmdline we run as a command line client contacting a server
+        // create URL
+        string url = "http://" + rpc_connect + ":" + lexical_cast<string>(rpc_port);
+        if(ssl) url = "https://" + rpc_connect + ":" + lexical_cast<string>(rpc_port);
+
+        // In batch mode we read the commands to send from a file or stdin
+        if (args.count("batch") || args.count("batchfile")) {
+            if (args.count("batchfile")) {
+                ifstream batch(batch_file.c_str());
+                if (!batch)
+                    throw runtime_error("Could not open batch file " + batch_file);
+                return BatchClient::run(batch, cout, url, auth, batch_size, rpc_concurrency);
+            }
+            return BatchClient::run(cin, cout, url, auth, batch_size, rpc_concurrency);
+        }
+
         if (args.count("params")) {
             string rpc_method = rpc_params[0];
             rpc_params.erase(rpc_params.begin());
-            // create URL
-            string url = "http://" + rpc_connect + ":" + lexical_cast<string>(rpc_port);
-            if(ssl) url = "https://" + rpc_connect + ":" + lexical_cast<string>(rpc_port);
             Client client;
             // this is a blocking post!
             Reply reply = client.post(url, RPC::content(rpc_method, rpc_params), auth.headers());
@@ -287,42 +379,66 @@ int main(int argc, char *argv[])
     }
 
 
-    // Get desired locale ("en_US") from command line or system locale
-    QString lang_territory = QString::fromStdString(locale);
-    // Load language files for configured locale:
-    // - First load the translator for the base language, without territory
-    // - Then load the more specific locale translator
-    QString lang = lang_territory;
+    // In headless mode the node and wallet are served over JSON-RPC only, so skip all
+    // widget, translation and pixmap initialization
+    bool fHeadless = args.count("daemon") || args.count("server");
 
-    lang.truncate(lang_territory.lastIndexOf('_')); // "en"
+    boost::scoped_ptr<QApplication> app;
+    boost::scoped_ptr<QCoreApplication> coreApp;
+    boost::scoped_ptr<QSplashScreen> splash;
     QTranslator qtTranslatorBase, qtTranslator, translatorBase, translator;
 
-    qtTranslatorBase.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + lang);
-    if (!qtTranslatorBase.isEmpty())
-        app.installTranslator(&qtTranslatorBase);
+    profiler.setReportFile(startup_profile);
+
+    if(!fHeadless)
+    {
+        StartupPhase("Loading translations...");
+        Q_INIT_RESOURCE(bitcoin);
+        app.reset(new QApplication(argc, argv));
+
+        // Get desired locale ("en_US") from command line or system locale
+        QString lang_territory = QString::fromStdString(locale);
+        // Load language files for configured locale:
+        // - First load the translator for the base language, without territory
+        // - Then load the more specific locale translator
+        QString lang = lang_territory;
 
-    qtTranslator.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + lang_territory);
-    if (!qtTranslator.isEmpty())
-        app.installTranslator(&qtTranslator);
+        lang.truncate(lang_territory.lastIndexOf('_')); // "en"
 
-    translatorBase.load(":/translations/"+lang);
-    if (!translatorBase.isEmpty())
-        app.installTranslator(&translatorBase);
+        qtTranslatorBase.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + lang);
+        if (!qtTranslatorBase.isEmpty())
+            app->installTranslator(&qtTranslatorBase);
 
-    translator.load(":/translations/"+lang_territory);
-    if (!translator.isEmpty())
-        app.installTranslator(&translator);
+        qtTranslator.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + lang_territory);
+        if (!qtTranslator.isEmpty())
+            app->installTranslator(&qtTranslator);
 
-    app.setApplicationName(QApplication::translate("main", "Coin-Qt"));
+        translatorBase.load(":/translations/"+lang);
+        if (!translatorBase.isEmpty())
+            app->installTranslator(&translatorBase);
 
-    QSplashScreen splash(QPixmap(":/images/splash"), 0);
-    splash.show();
-    splash.setAutoFillBackground(true);
-    splashref = &splash;
+        translator.load(":/translations/"+lang_territory);
+        if (!translator.isEmpty())
+            app->installTranslator(&translator);
 
-    app.processEvents();
+        app->setApplicationName(QApplication::translate("main", "Coin-Qt"));
 
-    app.setQuitOnLastWindowClosed(false);
+        StartupPhase("Showing splash screen...");
+        splash.reset(new QSplashScreen(QPixmap(":/images/splash"), 0));
+        splash->show();
+        splash->setAutoFillBackground(true);
+        splashref = splash.get();
+
+        app->processEvents();
+
+        app->setQuitOnLastWindowClosed(false);
+    }
+    else
+    {
+        // The rescanner and key pool refiller are QThreads, which expect an application
+        // object, even though no event loop is run
+        coreApp.reset(new QCoreApplication(argc, argv));
+    }
 
     try
     {
@@ -340,6 +456,7 @@ int main(int argc, char *argv[])
 
         logfile = data_dir + "/debug.log";
 
+        StartupPhase("Loading block index...");
         Node node(chain, data_dir, args.count("nolisten") ? "" : "0.0.0.0"); // it is also here we specify the use of a proxy!
 //        PortMapper(node.get_io_service(), port); // this will use the Node call
 
@@ -347,27 +464,95 @@ int main(int argc, char *argv[])
         for(strings::iterator ep = add_peers.begin(); ep != add_peers.end(); ++ep) node.addPeer(*ep);
         for(strings::iterator ep = connect_peers.begin(); ep != connect_peers.end(); ++ep) node.connectPeer(*ep);
 
+        StartupPhase("Loading wallet...");
+        bool fNewWallet = !filesystem::exists(data_dir + "/wallet.dat");
         Wallet wallet(node); // this will also register the needed callbacks
+        if(fNewWallet) {
+            WalletRescanner::setBirthday(&wallet, QDateTime::currentDateTime().toTime_t());
+            if(args.count("deterministic"))
+                DeterministicKeyChain::init(&wallet);
+        }
 
-        if(args.count("rescan")) {
-            wallet.ScanForWalletTransactions();
-            printf("Scanned for wallet transactions");
+        // Rescan from an explicit height or date, or else from the wallet birthday
+        bool fRescan = args.count("rescan") || args.count("rescanheight") || args.count("rescandate");
+        int rescanFrom = -1;
+        if(args.count("rescanheight"))
+            rescanFrom = rescan_height;
+        else if(args.count("rescandate")) {
+            QDate date = QDate::fromString(QString::fromStdString(rescan_date), Qt::ISODate);
+            if(!date.isValid())
+                throw runtime_error("Invalid -rescandate, expected YYYY-MM-DD: " + rescan_date);
+            rescanFrom = WalletRescanner::heightForTime(node, QDateTime(date).toTime_t());
+        }
+
+        // Without a GUI there is nothing to show progress in, so scan before serving requests
+        if(fHeadless && fRescan) {
+            StartupPhase("Rescanning...");
+            WalletRescanner rescanner(node, &wallet, rescanFrom);
+            rescanner.start();
+            rescanner.wait();
+            printf("Scanned for wallet transactions\n");
         }
 
         thread nodeThread(&Node::run, &node); // run this as a background thread
 
+        if(fHeadless)
+        {
+            // Keep enough keys in the pool for getnewaddress to never generate one while serving a request
+            KeyPoolRefiller refiller(&wallet, keypool_size);
+            refiller.start(QThread::LowestPriority);
+
+            // The asio loop of the RPC server is our event loop, it returns on a "stop" command
+            Server server(rpc_bind, lexical_cast<string>(rpc_port), filesystem::initial_path().string());
+            if(ssl) server.setCredentials(data_dir, certchain, privkey);
+            registerRPCMethods(server, node, wallet, auth);
+            profiler.finish();
+
+            serveRPC(&server, rpc_threads);
+            printf("RPC server stopped, shutting down Node...\n");
+
+            refiller.stop();
+            refiller.wait();
+
+            node.shutdown();
+            nodeThread.join();
+            return 0;
+        }
+
+        StartupPhase("Creating models...");
+        // Options are stored in the default wallet. The manager outlives the GUI block, so that
+        // any additional wallets are only deleted after the node has been shut down.
+        OptionsModel optionsModel(&wallet);
+        WalletManager walletManager(node, data_dir, &optionsModel);
+        walletManager.setKeyPoolSize(keypool_size);
+        walletManager.setDeterministic(args.count("deterministic"));
+        walletManager.addWallet(QString::fromStdString(wallet.strWalletFile), &wallet);
+        for(strings::iterator wf = wallet_files.begin(); wf != wallet_files.end(); ++wf)
+            walletManager.registerWallet(QString::fromStdString(*wf));
+
+        // Serve JSON-RPC for the default wallet in the background while the GUI runs
+        boost::scoped_ptr<Server> rpcServer;
+        boost::scoped_ptr<boost::thread> rpcThread;
+        if(args.count("rpcserver"))
+        {
+            rpcServer.reset(new Server(rpc_bind, lexical_cast<string>(rpc_port), filesystem::initial_path().string()));
+            if(ssl) rpcServer->setCredentials(data_dir, certchain, privkey);
+            registerRPCMethods(*rpcServer, node, wallet, auth);
+            rpcThread.reset(new boost::thread(boost::bind(&serveRPC, rpcServer.get(), rpc_threads)));
+        }
+
         {
             // Put this in a block, so that BitcoinGUI is cleaned up properly before
             // calling Shutdown() in case of exceptions.
+            StartupPhase("Creating main window...");
             BitcoinGUI window;
-            splash.finish(&window);
-            OptionsModel optionsModel(&wallet);
+            splash->finish(&window);
+            splashref = 0;
             ClientModel clientModel(node, &optionsModel);
-            WalletModel walletModel(&wallet, &optionsModel);
 
             guiref = &window;
             window.setClientModel(&clientModel);
-            window.setWalletModel(&walletModel);
+            window.setWalletManager(&walletManager);
 
             // If -min option passed, start window minimized.
             if(args.count("min"))
@@ -375,31 +560,38 @@ int main(int argc, char *argv[])
             else
                 window.show();
 
-            // Place this here as guiref has to be defined if we dont want to lose URLs
-            /*
-            ipcInit(); // we skip the ipc as it consumes 100% cpu ???
-            // Check for URL in argv
-            for (int i = 1; i < argc; i++)
-            {
-                if (strlen(argv[i]) > 7 && strncasecmp(argv[i], "bitcoin:", 8) == 0)
-                {
-                    const char *strURL = argv[i];
-                    try {
-                        boost::interprocess::message_queue mq(boost::interprocess::open_only, "BitcoinURL");
-                        mq.try_send(strURL, strlen(strURL), 0);
-                    }
-                    catch (boost::interprocess::interprocess_exception &ex) {
-                    }
-                }
-            }
-            */
-            app.exec();
+            // The first timer event is delivered once the pending paint events of the window are handled
+            StartupPhase("Showing main window...");
+            QTimer::singleShot(0, &profiler, SLOT(finish()));
+
+            // Rescan in the background, with progress in the status bar
+            if(fRescan)
+                window.setRescanner(walletManager.rescan(QString::fromStdString(wallet.strWalletFile), rescanFrom));
 
+            // Place this here as guiref has to be defined if we dont want to lose URLs
+            IPCServer ipcServer;
+            QObject::connect(&ipcServer, SIGNAL(receivedURL(QString)), &window, SLOT(showNormal()));
+            QObject::connect(&ipcServer, SIGNAL(receivedURL(QString)), &window, SLOT(handleURL(QString)));
+            if(!ipcServer.listen())
+                printf("Could not listen for URIs from other instances\n");
+            foreach(const QString &url, urls)
+                window.handleURL(url);
+
+            app->exec();
+
+            walletManager.stopRescan();
+            walletManager.stopKeyPoolRefill();
             guiref = 0;
         }
         printf("GUI exitted, shutting down Node...\n");
         // getting here means that we have exited from the gui (e.g. by the quit method)
 
+        if(rpcServer)
+        {
+            rpcServer->shutdown();
+            rpcThread->join();
+        }
+
         node.shutdown();
         nodeThread.join();
     } catch (std::exception& e) {
@@ -409,4 +601,4 @@ int main(int argc, char *argv[])
     }
     return 0;
 }
-#endif // BITCOIN_QT_TEST
+#endif // !BITCOIN_QT_TEST && !BITCOIN_QT_BENCH
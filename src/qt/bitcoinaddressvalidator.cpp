@@ -1,4 +1,5 @@
 #include "bitcoinaddressvalidator.h"
+#include "addresschecker.h"
 
 /* Base58 characters are:
      "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
@@ -63,5 +64,13 @@ QValidator::State BitcoinAddressValidator::validate(QString &input, int &pos) co
         state = QValidator::Intermediate;
     }
 
+    // Complete addresses with a wrong checksum are "intermediate" input as well, so that
+    // the field shows them as invalid before the wallet is asked
+    if(state == QValidator::Acceptable && input.size() >= AddressChecker::MIN_ADDRESS_LENGTH &&
+       AddressChecker::check(input) != AddressChecker::Valid)
+    {
+        state = QValidator::Intermediate;
+    }
+
     return state;
 }
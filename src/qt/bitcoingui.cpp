@@ -13,6 +13,8 @@
 #include "aboutdialog.h"
 #include "clientmodel.h"
 #include "walletmodel.h"
+#include "walletmanager.h"
+#include "walletrescanner.h"
 #include "editaddressdialog.h"
 #include "optionsmodel.h"
 #include "transactiondescdialog.h"
@@ -22,6 +24,11 @@
 #include "bitcoinunits.h"
 #include "guiconstants.h"
 #include "askpassphrasedialog.h"
+#include "rescandialog.h"
+#include "syncdiagnosticsdialog.h"
+#include "peersdialog.h"
+#include "memorydialog.h"
+#include "memoryusage.h"
 #include "notificator.h"
 
 #ifdef Q_WS_MAC
@@ -38,8 +45,10 @@
 #include <QToolBar>
 #include <QStatusBar>
 #include <QLabel>
+#include <QComboBox>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QToolButton>
 #include <QLocale>
 #include <QMessageBox>
 #include <QProgressBar>
@@ -51,6 +60,7 @@
 
 #include <QDragEnterEvent>
 #include <QUrl>
+#include <QTimer>
 
 #include <iostream>
 
@@ -58,12 +68,20 @@ BitcoinGUI::BitcoinGUI(QWidget *parent):
     QMainWindow(parent),
     clientModel(0),
     walletModel(0),
+    walletManager(0),
     dummyWidget(0),
+    transactionsPage(0),
+    addressBookPage(0),
+    receiveCoinsPage(0),
+    sendCoinsPage(0),
+    messagePage(0),
+    rescanner(0),
     encryptWalletAction(0),
     changePassphraseAction(0),
     aboutQtAction(0),
     trayIcon(0),
-    notificator(0)
+    notificator(0),
+    transactionView(0)
 {
     resize(850, 550);
     setWindowTitle(tr("Bitcoin Wallet"));
@@ -91,32 +109,12 @@ BitcoinGUI::BitcoinGUI(QWidget *parent):
     // Dummy widget used when restoring window state after minimization
     dummyWidget = new QWidget();
 
-    // Create tabs
+    // Create tabs. Only the overview page is created up front, the other pages are created
+    // on first navigation, or in the background once the window is up.
     overviewPage = new OverviewPage();
 
-    transactionsPage = new QWidget(this);
-    QVBoxLayout *vbox = new QVBoxLayout();
-    transactionView = new TransactionView(this);
-    vbox->addWidget(transactionView);
-    transactionsPage->setLayout(vbox);
-
-    addressBookPage = new AddressBookPage(AddressBookPage::ForEditing, AddressBookPage::SendingTab);
-
-    receiveCoinsPage = new AddressBookPage(AddressBookPage::ForEditing, AddressBookPage::ReceivingTab);
-
-    sendCoinsPage = new SendCoinsDialog(this);
-
-    messagePage = new MessagePage(this);
-
     centralWidget = new QStackedWidget(this);
     centralWidget->addWidget(overviewPage);
-    centralWidget->addWidget(transactionsPage);
-    centralWidget->addWidget(addressBookPage);
-    centralWidget->addWidget(receiveCoinsPage);
-    centralWidget->addWidget(sendCoinsPage);
-#ifdef FIRST_CLASS_MESSAGING
-    centralWidget->addWidget(messagePage);
-#endif
     setCentralWidget(centralWidget);
 
     // Create status bar
@@ -148,8 +146,29 @@ BitcoinGUI::BitcoinGUI(QWidget *parent):
     progressBar->setToolTip(tr("Block chain synchronization in progress"));
     progressBar->setVisible(false);
 
+    // Progress of a background wallet rescan, next to the synchronization progress
+    rescanFrame = new QFrame();
+    QHBoxLayout *rescanLayout = new QHBoxLayout(rescanFrame);
+    rescanLayout->setContentsMargins(0,0,0,0);
+    rescanLayout->setSpacing(3);
+    rescanProgressBar = new QProgressBar();
+    rescanProgressBar->setFormat(tr("Rescanning %p%"));
+    rescanPauseButton = new QToolButton();
+    rescanPauseButton->setText(tr("Pause"));
+    rescanPauseButton->setToolTip(tr("Pause or resume the wallet rescan"));
+    QToolButton *rescanCancelButton = new QToolButton();
+    rescanCancelButton->setText(tr("Cancel"));
+    rescanCancelButton->setToolTip(tr("Stop the wallet rescan"));
+    rescanLayout->addWidget(rescanProgressBar);
+    rescanLayout->addWidget(rescanPauseButton);
+    rescanLayout->addWidget(rescanCancelButton);
+    rescanFrame->setVisible(false);
+    connect(rescanPauseButton, SIGNAL(clicked()), this, SLOT(toggleRescanPaused()));
+    connect(rescanCancelButton, SIGNAL(clicked()), this, SLOT(cancelRescan()));
+
     statusBar()->addWidget(progressBarLabel);
     statusBar()->addWidget(progressBar);
+    statusBar()->addWidget(rescanFrame);
     statusBar()->addPermanentWidget(frameBlocks);
 
     syncIconMovie = new QMovie(":/movies/update_spinner", "mng", this);
@@ -157,10 +176,9 @@ BitcoinGUI::BitcoinGUI(QWidget *parent):
     // Clicking on a transaction on the overview page simply sends you to transaction history page
     connect(overviewPage, SIGNAL(transactionClicked(QModelIndex)), this, SLOT(gotoHistoryPage()));
 
-    // Doubleclicking on a transaction on the transaction history page shows details
-    connect(transactionView, SIGNAL(doubleClicked(QModelIndex)), transactionView, SLOT(showDetails()));
-
     gotoOverviewPage();
+
+    QTimer::singleShot(PAGE_CREATE_DELAY, this, SLOT(createNextPage()));
 }
 
 BitcoinGUI::~BitcoinGUI()
@@ -237,6 +255,12 @@ void BitcoinGUI::createActions()
     aboutQtAction = new QAction(tr("About &Qt"), this);
     aboutQtAction->setToolTip(tr("Show information about Qt"));
     aboutQtAction->setMenuRole(QAction::AboutQtRole);
+    syncDiagnosticsAction = new QAction(tr("&Synchronization Diagnostics..."), this);
+    syncDiagnosticsAction->setToolTip(tr("Show block chain synchronization throughput and estimated time left"));
+    peersAction = new QAction(tr("&Peers..."), this);
+    peersAction->setToolTip(tr("Show statistics of the connected peers"));
+    memoryAction = new QAction(tr("&Memory Usage..."), this);
+    memoryAction->setToolTip(tr("Show the memory used by the main caches and structures"));
     optionsAction = new QAction(QIcon(":/icons/options"), tr("&Options..."), this);
     optionsAction->setToolTip(tr("Modify configuration options for bitcoin"));
     optionsAction->setMenuRole(QAction::PreferencesRole);
@@ -251,15 +275,25 @@ void BitcoinGUI::createActions()
     backupWalletAction->setToolTip(tr("Backup wallet to another location"));
     changePassphraseAction = new QAction(QIcon(":/icons/key"), tr("&Change Passphrase"), this);
     changePassphraseAction->setToolTip(tr("Change the passphrase used for wallet encryption"));
+    rescanAction = new QAction(tr("&Rescan Wallet..."), this);
+    rescanAction->setToolTip(tr("Search the block chain for missing wallet transactions"));
 
     connect(quitAction, SIGNAL(triggered()), qApp, SLOT(quit()));
     connect(optionsAction, SIGNAL(triggered()), this, SLOT(optionsClicked()));
     connect(aboutAction, SIGNAL(triggered()), this, SLOT(aboutClicked()));
     connect(aboutQtAction, SIGNAL(triggered()), qApp, SLOT(aboutQt()));
+    connect(syncDiagnosticsAction, SIGNAL(triggered()), this, SLOT(syncDiagnosticsClicked()));
+    connect(peersAction, SIGNAL(triggered()), this, SLOT(peersClicked()));
+    connect(memoryAction, SIGNAL(triggered()), this, SLOT(memoryClicked()));
+
+    // Dump memory usage to the debug log on SIGUSR1
+    MemoryUsageSignal *memorySignal = new MemoryUsageSignal(this);
+    connect(memorySignal, SIGNAL(requested()), this, SLOT(dumpMemoryUsage()));
     connect(openBitcoinAction, SIGNAL(triggered()), this, SLOT(showNormal()));
     connect(encryptWalletAction, SIGNAL(triggered(bool)), this, SLOT(encryptWallet(bool)));
     connect(backupWalletAction, SIGNAL(triggered()), this, SLOT(backupWallet()));
     connect(changePassphraseAction, SIGNAL(triggered()), this, SLOT(changePassphrase()));
+    connect(rescanAction, SIGNAL(triggered()), this, SLOT(rescanWallet()));
 }
 
 void BitcoinGUI::createMenuBar()
@@ -285,10 +319,15 @@ void BitcoinGUI::createMenuBar()
     settings->addAction(encryptWalletAction);
     settings->addAction(changePassphraseAction);
     settings->addAction(backupWalletAction);
+    settings->addAction(rescanAction);
     settings->addSeparator();
     settings->addAction(optionsAction);
 
     QMenu *help = appMenuBar->addMenu(tr("&Help"));
+    help->addAction(syncDiagnosticsAction);
+    help->addAction(peersAction);
+    help->addAction(memoryAction);
+    help->addSeparator();
     help->addAction(aboutAction);
     help->addAction(aboutQtAction);
 }
@@ -309,6 +348,15 @@ void BitcoinGUI::createToolBars()
     QToolBar *toolbar2 = addToolBar(tr("Actions toolbar"));
     toolbar2->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
     toolbar2->addAction(exportAction);
+
+    // Wallet switcher, only shown when there is more than one wallet
+    walletToolbar = addToolBar(tr("Wallets toolbar"));
+    walletSelector = new QComboBox();
+    walletSelector->setToolTip(tr("Select the wallet to show"));
+    walletSelector->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    walletToolbar->addWidget(walletSelector);
+    walletToolbar->setVisible(false);
+    connect(walletSelector, SIGNAL(activated(QString)), this, SLOT(walletSelected(QString)));
 }
 
 void BitcoinGUI::setClientModel(ClientModel *clientModel)
@@ -346,33 +394,160 @@ void BitcoinGUI::setClientModel(ClientModel *clientModel)
 
 void BitcoinGUI::setWalletModel(WalletModel *walletModel)
 {
+    if(this->walletModel)
+    {
+        // Stop listening to the previously shown wallet
+        disconnect(this->walletModel, 0, this, 0);
+        if(this->walletModel->getExistingTransactionTableModel())
+            disconnect(this->walletModel->getExistingTransactionTableModel(), 0, this, 0);
+    }
     this->walletModel = walletModel;
     if(walletModel)
     {
         // Report errors from wallet thread
         connect(walletModel, SIGNAL(error(QString,QString)), this, SLOT(error(QString,QString)));
 
-        // Put transaction list in tabs
-        transactionView->setModel(walletModel);
-
+        // Put transaction list in tabs, pages that are not created yet get the model when they are
         overviewPage->setModel(walletModel);
-        addressBookPage->setModel(walletModel->getAddressTableModel());
-        receiveCoinsPage->setModel(walletModel->getAddressTableModel());
-        sendCoinsPage->setModel(walletModel);
-        messagePage->setModel(walletModel);
+        if(transactionView)
+            transactionView->setModel(walletModel);
+        if(addressBookPage)
+            addressBookPage->setModel(walletModel->getAddressTableModel());
+        if(receiveCoinsPage)
+            receiveCoinsPage->setModel(walletModel->getAddressTableModel());
+        if(sendCoinsPage)
+            sendCoinsPage->setModel(walletModel);
+        if(messagePage)
+            messagePage->setModel(walletModel);
 
         setEncryptionStatus(walletModel->getEncryptionStatus());
         connect(walletModel, SIGNAL(encryptionStatusChanged(int)), this, SLOT(setEncryptionStatus(int)));
 
-        // Balloon popup for new transaction
-        connect(walletModel->getTransactionTableModel(), SIGNAL(rowsInserted(QModelIndex,int,int)),
-                this, SLOT(incomingTransaction(QModelIndex,int,int)));
+        // Balloon popup for new transaction. The table model is not created here, the overview
+        // and transaction pages create it when they are shown or built in the background.
+        if(walletModel->getExistingTransactionTableModel())
+            watchTransactions(walletModel->getExistingTransactionTableModel());
+        connect(walletModel, SIGNAL(transactionTableModelCreated(TransactionTableModel*)),
+                this, SLOT(watchTransactions(TransactionTableModel*)));
 
         // Ask for passphrase if needed
         connect(walletModel, SIGNAL(requireUnlock()), this, SLOT(unlockWallet()));
     }
 }
 
+void BitcoinGUI::setWalletManager(WalletManager *walletManager)
+{
+    this->walletManager = walletManager;
+    walletSelector->clear();
+    if(walletManager)
+    {
+        QStringList names = walletManager->walletNames();
+        walletSelector->addItems(names);
+        walletToolbar->setVisible(names.size() > 1);
+
+        // Report errors from loading wallets
+        connect(walletManager, SIGNAL(error(QString,QString)), this, SLOT(error(QString,QString)));
+        connect(walletManager, SIGNAL(walletLoaded(QString,WalletModel*)), this, SLOT(walletLoaded(QString,WalletModel*)));
+
+        if(!names.isEmpty())
+            walletSelected(names.at(0));
+    }
+}
+
+void BitcoinGUI::walletSelected(const QString &name)
+{
+    if(!walletManager)
+        return;
+    // Keep showing the current wallet until the selected one is loaded, if it fails to load
+    // the selection simply stays where it is
+    walletSelector->setCurrentIndex(walletSelector->findText(currentWalletName));
+    requestedWalletName = name;
+    walletManager->loadWallet(name);
+}
+
+void BitcoinGUI::walletLoaded(const QString &name, WalletModel *model)
+{
+    // Only switch to the wallet that was selected last
+    if(name != requestedWalletName)
+        return;
+    if(model != walletModel)
+        setWalletModel(model);
+    currentWalletName = name;
+    walletSelector->setCurrentIndex(walletSelector->findText(name));
+}
+
+void BitcoinGUI::setRescanner(WalletRescanner *rescanner)
+{
+    this->rescanner = rescanner;
+    if(rescanner)
+    {
+        rescanProgressBar->setMaximum(0); // Busy indicator until the first batch is done
+        rescanProgressBar->setToolTip(tr("Rescanning the block chain for wallet transactions"));
+        rescanPauseButton->setText(tr("Pause"));
+        rescanFrame->setVisible(true);
+
+        connect(rescanner, SIGNAL(progress(int,int,int)), this, SLOT(setRescanProgress(int,int,int)));
+        connect(rescanner, SIGNAL(scanFinished(int,bool)), this, SLOT(rescanFinished(int,bool)));
+    }
+    else
+    {
+        rescanFrame->setVisible(false);
+    }
+}
+
+void BitcoinGUI::setRescanProgress(int height, int tipHeight, int secsRemaining)
+{
+    rescanProgressBar->setMaximum(tipHeight);
+    rescanProgressBar->setValue(height);
+
+    QString tooltip = tr("Rescanned %1 of %2 blocks for wallet transactions.").arg(height).arg(tipHeight);
+    if(secsRemaining >= 0)
+    {
+        QString eta;
+        if(secsRemaining < 60)
+            eta = tr("%n second(s)","",secsRemaining);
+        else if(secsRemaining < 60*60)
+            eta = tr("%n minute(s)","",secsRemaining/60);
+        else
+            eta = tr("%n hour(s)","",secsRemaining/(60*60));
+        tooltip += QString("\n") + tr("About %1 remaining.").arg(eta);
+    }
+    rescanProgressBar->setToolTip(tooltip);
+}
+
+void BitcoinGUI::rescanFinished(int found, bool cancelled)
+{
+    rescanFrame->setVisible(false);
+    rescanner = 0;
+    if(!cancelled)
+    {
+        notificator->notify(Notificator::Information, tr("Rescan complete"),
+                            tr("Found %n wallet transaction(s) in the block chain.", "", found));
+    }
+}
+
+void BitcoinGUI::toggleRescanPaused()
+{
+    if(!rescanner)
+        return;
+    if(rescanner->isPaused())
+    {
+        rescanner->resume();
+        rescanPauseButton->setText(tr("Pause"));
+    }
+    else
+    {
+        rescanner->pause();
+        rescanPauseButton->setText(tr("Resume"));
+    }
+}
+
+void BitcoinGUI::cancelRescan()
+{
+    if(rescanner)
+        rescanner->cancel();
+}
+
 void BitcoinGUI::createTrayIcon()
 {
     QMenu *trayIconMenu;
@@ -446,6 +621,37 @@ void BitcoinGUI::aboutClicked()
     dlg.exec();
 }
 
+void BitcoinGUI::syncDiagnosticsClicked()
+{
+    // Not modal, so that it can be watched while using the wallet
+    SyncDiagnosticsDialog *dlg = new SyncDiagnosticsDialog(this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setModel(clientModel);
+    dlg->show();
+}
+
+void BitcoinGUI::peersClicked()
+{
+    PeersDialog *dlg = new PeersDialog(this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setModel(clientModel);
+    dlg->show();
+}
+
+void BitcoinGUI::memoryClicked()
+{
+    MemoryDialog *dlg = new MemoryDialog(this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setModels(clientModel, walletManager);
+    dlg->show();
+}
+
+void BitcoinGUI::dumpMemoryUsage()
+{
+    QString table = MemoryAccounting::format(MemoryAccounting::collect(clientModel, walletManager));
+    printf("Memory usage:\n%s\n", table.toStdString().c_str());
+}
+
 void BitcoinGUI::setNumConnections(int count)
 {
     QString icon;
@@ -613,6 +819,12 @@ void BitcoinGUI::askFee(qint64 nFeeRequired, bool *payFee)
     *payFee = (retval == QMessageBox::Yes);
 }
 
+void BitcoinGUI::watchTransactions(TransactionTableModel *model)
+{
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(incomingTransaction(QModelIndex,int,int)));
+}
+
 void BitcoinGUI::incomingTransaction(const QModelIndex & parent, int start, int end)
 {
     if(!walletModel || !clientModel)
@@ -648,6 +860,87 @@ void BitcoinGUI::incomingTransaction(const QModelIndex & parent, int start, int
     }
 }
 
+void BitcoinGUI::createTransactionsPage()
+{
+    if(transactionsPage)
+        return;
+    transactionsPage = new QWidget(this);
+    QVBoxLayout *vbox = new QVBoxLayout();
+    transactionView = new TransactionView(this);
+    vbox->addWidget(transactionView);
+    transactionsPage->setLayout(vbox);
+    centralWidget->addWidget(transactionsPage);
+
+    // Doubleclicking on a transaction on the transaction history page shows details
+    connect(transactionView, SIGNAL(doubleClicked(QModelIndex)), transactionView, SLOT(showDetails()));
+
+    if(walletModel)
+        transactionView->setModel(walletModel);
+}
+
+void BitcoinGUI::createAddressBookPage()
+{
+    if(addressBookPage)
+        return;
+    addressBookPage = new AddressBookPage(AddressBookPage::ForEditing, AddressBookPage::SendingTab);
+    centralWidget->addWidget(addressBookPage);
+    if(walletModel)
+        addressBookPage->setModel(walletModel->getAddressTableModel());
+}
+
+void BitcoinGUI::createReceiveCoinsPage()
+{
+    if(receiveCoinsPage)
+        return;
+    receiveCoinsPage = new AddressBookPage(AddressBookPage::ForEditing, AddressBookPage::ReceivingTab);
+    centralWidget->addWidget(receiveCoinsPage);
+    if(walletModel)
+        receiveCoinsPage->setModel(walletModel->getAddressTableModel());
+}
+
+void BitcoinGUI::createSendCoinsPage()
+{
+    if(sendCoinsPage)
+        return;
+    sendCoinsPage = new SendCoinsDialog(this);
+    centralWidget->addWidget(sendCoinsPage);
+    if(walletModel)
+        sendCoinsPage->setModel(walletModel);
+}
+
+void BitcoinGUI::createMessagePage()
+{
+    if(messagePage)
+        return;
+    messagePage = new MessagePage(this);
+#ifdef FIRST_CLASS_MESSAGING
+    centralWidget->addWidget(messagePage);
+#endif
+    if(walletModel)
+        messagePage->setModel(walletModel);
+}
+
+void BitcoinGUI::createNextPage()
+{
+    // Create one page per event loop iteration, to keep the window responsive meanwhile
+    if(!sendCoinsPage)
+        createSendCoinsPage();
+    else if(!receiveCoinsPage)
+        createReceiveCoinsPage();
+    else if(!transactionsPage)
+        createTransactionsPage();
+    else if(!addressBookPage)
+        createAddressBookPage();
+#ifdef FIRST_CLASS_MESSAGING
+    // Otherwise messages are signed in a dialog window of its own, created when it is first opened
+    else if(!messagePage)
+        createMessagePage();
+#endif
+    else
+        return;
+    QTimer::singleShot(0, this, SLOT(createNextPage()));
+}
+
 void BitcoinGUI::gotoOverviewPage()
 {
     overviewAction->setChecked(true);
@@ -659,6 +952,7 @@ void BitcoinGUI::gotoOverviewPage()
 
 void BitcoinGUI::gotoHistoryPage()
 {
+    createTransactionsPage();
     historyAction->setChecked(true);
     centralWidget->setCurrentWidget(transactionsPage);
 
@@ -669,6 +963,7 @@ void BitcoinGUI::gotoHistoryPage()
 
 void BitcoinGUI::gotoAddressBookPage()
 {
+    createAddressBookPage();
     addressBookAction->setChecked(true);
     centralWidget->setCurrentWidget(addressBookPage);
 
@@ -679,6 +974,7 @@ void BitcoinGUI::gotoAddressBookPage()
 
 void BitcoinGUI::gotoReceiveCoinsPage()
 {
+    createReceiveCoinsPage();
     receiveCoinsAction->setChecked(true);
     centralWidget->setCurrentWidget(receiveCoinsPage);
 
@@ -689,6 +985,7 @@ void BitcoinGUI::gotoReceiveCoinsPage()
 
 void BitcoinGUI::gotoSendCoinsPage()
 {
+    createSendCoinsPage();
     sendCoinsAction->setChecked(true);
     centralWidget->setCurrentWidget(sendCoinsPage);
 
@@ -698,6 +995,7 @@ void BitcoinGUI::gotoSendCoinsPage()
 
 void BitcoinGUI::gotoMessagePage()
 {
+    createMessagePage();
 #ifdef FIRST_CLASS_MESSAGING
     messageAction->setChecked(true);
     centralWidget->setCurrentWidget(messagePage);
@@ -796,6 +1094,35 @@ void BitcoinGUI::backupWallet()
     }
 }
 
+void BitcoinGUI::rescanWallet()
+{
+    if(!walletManager || !clientModel)
+        return;
+    if(rescanner)
+    {
+        QMessageBox::information(this, tr("Rescan Wallet"), tr("A rescan is already in progress."));
+        return;
+    }
+
+    RescanDialog dlg(walletManager->getBirthday(currentWalletName), clientModel->getNumBlocks(), this);
+    if(!dlg.exec())
+        return;
+
+    int startHeight = -1;
+    switch(dlg.getMode())
+    {
+    case RescanDialog::FromBirthday:
+        break;
+    case RescanDialog::FromDate:
+        startHeight = walletManager->heightForDate(dlg.getDate());
+        break;
+    case RescanDialog::FromHeight:
+        startHeight = dlg.getHeight();
+        break;
+    }
+    setRescanner(walletManager->rescan(currentWalletName, startHeight));
+}
+
 void BitcoinGUI::changePassphrase()
 {
     AskPassphraseDialog dlg(AskPassphraseDialog::ChangePass, this);
@@ -7,6 +7,8 @@
 class TransactionTableModel;
 class ClientModel;
 class WalletModel;
+class WalletManager;
+class WalletRescanner;
 class TransactionView;
 class OverviewPage;
 class AddressBookPage;
@@ -16,12 +18,15 @@ class Notificator;
 
 QT_BEGIN_NAMESPACE
 class QLabel;
+class QComboBox;
 class QLineEdit;
 class QTableView;
 class QAbstractItemModel;
 class QModelIndex;
 class QProgressBar;
 class QStackedWidget;
+class QToolBar;
+class QToolButton;
 class QUrl;
 QT_END_NAMESPACE
 
@@ -45,6 +50,15 @@ public:
         functionality.
     */
     void setWalletModel(WalletModel *walletModel);
+    /** Set the wallet manager.
+        When more than one wallet is known to the manager, a wallet switcher is shown in the toolbar and
+        selecting a wallet loads it if needed and makes it the current wallet model.
+    */
+    void setWalletManager(WalletManager *walletManager);
+    /** Show progress of a background wallet rescan in the status bar, with pause and cancel buttons.
+        The rescanner stays owned by the caller.
+    */
+    void setRescanner(WalletRescanner *rescanner);
     
 protected:
     void changeEvent(QEvent *e);
@@ -55,6 +69,7 @@ protected:
 private:
     ClientModel *clientModel;
     WalletModel *walletModel;
+    WalletManager *walletManager;
 
     QStackedWidget *centralWidget;
 
@@ -73,6 +88,11 @@ private:
     QLabel *progressBarLabel;
     QProgressBar *progressBar;
 
+    WalletRescanner *rescanner;
+    QFrame *rescanFrame;
+    QProgressBar *rescanProgressBar;
+    QToolButton *rescanPauseButton;
+
     QMenuBar *appMenuBar;
     QAction *overviewAction;
     QAction *historyAction;
@@ -88,7 +108,11 @@ private:
     QAction *encryptWalletAction;
     QAction *backupWalletAction;
     QAction *changePassphraseAction;
+    QAction *rescanAction;
     QAction *aboutQtAction;
+    QAction *syncDiagnosticsAction;
+    QAction *peersAction;
+    QAction *memoryAction;
 
     QSystemTrayIcon *trayIcon;
     Notificator *notificator;
@@ -96,6 +120,12 @@ private:
 
     QMovie *syncIconMovie;
 
+    QToolBar *walletToolbar;
+    QComboBox *walletSelector;
+    QString currentWalletName;
+    // Wallet selected last, shown once it is loaded
+    QString requestedWalletName;
+
     /** Create the main UI actions. */
     void createActions();
     /** Create the menu bar and submenus. */
@@ -105,6 +135,13 @@ private:
     /** Create system tray (notification) icon */
     void createTrayIcon();
 
+    /** Create the pages other than the overview page, if not created yet */
+    void createTransactionsPage();
+    void createAddressBookPage();
+    void createReceiveCoinsPage();
+    void createSendCoinsPage();
+    void createMessagePage();
+
 public slots:
     /** Set number of connections shown in the UI */
     void setNumConnections(int count);
@@ -147,11 +184,36 @@ private slots:
     void gotoReceiveCoinsPage();
     /** Switch to send coins page */
     void gotoSendCoinsPage();
+    /** Load the wallet selected in the wallet switcher, and switch to it once loaded */
+    void walletSelected(const QString &name);
+    /** Show a wallet that finished loading, if it is still the one selected */
+    void walletLoaded(const QString &name, WalletModel *model);
+    /** Create the next page that was not visited yet, and schedule the one after it */
+    void createNextPage();
+
+    /** Update rescan progress bar and ETA */
+    void setRescanProgress(int height, int tipHeight, int secsRemaining);
+    /** Remove rescan progress from the status bar */
+    void rescanFinished(int found, bool cancelled);
+    /** Pause or resume the running rescan */
+    void toggleRescanPaused();
+    /** Stop the running rescan */
+    void cancelRescan();
+    /** Ask where to start, and rescan the current wallet */
+    void rescanWallet();
 
     /** Show configuration dialog */
     void optionsClicked();
     /** Show about dialog */
     void aboutClicked();
+    /** Show synchronization diagnostics */
+    void syncDiagnosticsClicked();
+    /** Show peer statistics */
+    void peersClicked();
+    /** Show memory usage debug window */
+    void memoryClicked();
+    /** Write memory usage to the debug log */
+    void dumpMemoryUsage();
 #ifndef Q_WS_MAC
     /** Handle tray icon clicked */
     void trayIconActivated(QSystemTrayIcon::ActivationReason reason);
@@ -161,6 +223,8 @@ private slots:
         The new items are those between start and end inclusive, under the given parent item.
     */
     void incomingTransaction(const QModelIndex & parent, int start, int end);
+    /** Watch a transaction table model for incoming transactions, once a page has created it */
+    void watchTransactions(TransactionTableModel *model);
     /** Encrypt the wallet */
     void encryptWallet(bool status);
     /** Backup the wallet */
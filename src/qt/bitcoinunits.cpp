@@ -1,7 +1,5 @@
 #include "bitcoinunits.h"
 
-#include <QStringList>
-
 BitcoinUnits::BitcoinUnits(QObject *parent):
         QAbstractListModel(parent),
         unitlist(availableUnits())
@@ -17,6 +15,22 @@ QList<BitcoinUnits::Unit> BitcoinUnits::availableUnits()
     return unitlist;
 }
 
+// Per-unit constants, indexed by unit
+struct UnitInfo
+{
+    qint64 factor;      // Number of Satoshis (1e-8) per unit
+    int decimals;       // Number of decimals left
+    int amountDigits;   // Number of amount digits (to represent max number of coins)
+    ushort name[5];     // Short name, UTF-16 and 0 terminated
+    const char *description;
+};
+
+static const UnitInfo unitInfo[] = {
+    { 100000000, 8, 8,  {'B', 'T', 'C', 0}, "Bitcoins" },                               // 21,000,000
+    { 100000,    5, 11, {'m', 'B', 'T', 'C', 0}, "Milli-Bitcoins (1 / 1,000)" },        // 21,000,000,000
+    { 100,       2, 14, {0x03BC, 'B', 'T', 'C', 0}, "Micro-Bitcoins (1 / 1,000,000)" }  // 21,000,000,000,000
+};
+
 bool BitcoinUnits::valid(int unit)
 {
     switch(unit)
@@ -32,126 +46,154 @@ bool BitcoinUnits::valid(int unit)
 
 QString BitcoinUnits::name(int unit)
 {
-    switch(unit)
-    {
-    case BTC: return QString("BTC");
-    case mBTC: return QString("mBTC");
-    case uBTC: return QString::fromUtf8("μBTC");
-    default: return QString("???");
-    }
+    if(!valid(unit))
+        return QString("???");
+    return QString::fromUtf16(unitInfo[unit].name);
 }
 
 QString BitcoinUnits::description(int unit)
 {
-    switch(unit)
-    {
-    case BTC: return QString("Bitcoins");
-    case mBTC: return QString("Milli-Bitcoins (1 / 1,000)");
-    case uBTC: return QString("Micro-Bitcoins (1 / 1,000,000)");
-    default: return QString("???");
-    }
+    if(!valid(unit))
+        return QString("???");
+    return QString(unitInfo[unit].description);
 }
 
 qint64 BitcoinUnits::factor(int unit)
 {
-    switch(unit)
-    {
-    case BTC:  return 100000000;
-    case mBTC: return 100000;
-    case uBTC: return 100;
-    default:   return 100000000;
-    }
+    return valid(unit) ? unitInfo[unit].factor : 100000000;
 }
 
 int BitcoinUnits::amountDigits(int unit)
 {
-    switch(unit)
-    {
-    case BTC: return 8; // 21,000,000 (# digits, without commas)
-    case mBTC: return 11; // 21,000,000,000
-    case uBTC: return 14; // 21,000,000,000,000
-    default: return 0;
-    }
+    return valid(unit) ? unitInfo[unit].amountDigits : 0;
 }
 
 int BitcoinUnits::decimals(int unit)
 {
-    switch(unit)
-    {
-    case BTC: return 8;
-    case mBTC: return 5;
-    case uBTC: return 2;
-    default: return 0;
-    }
+    return valid(unit) ? unitInfo[unit].decimals : 0;
 }
 
-QString BitcoinUnits::format(int unit, qint64 n, bool fPlus)
+int BitcoinUnits::format(int unit, qint64 n, bool fPlus, QChar *buf)
 {
     // Note: not using straight sprintf here because we do NOT want
     // localized number formatting.
     if(!valid(unit))
-        return QString(); // Refuse to format invalid unit
-    qint64 coin = factor(unit);
-    int num_decimals = decimals(unit);
-    qint64 n_abs = (n > 0 ? n : -n);
-    qint64 quotient = n_abs / coin;
-    qint64 remainder = n_abs % coin;
-    QString quotient_str = QString::number(quotient);
-    QString remainder_str = QString::number(remainder).rightJustified(num_decimals, '0');
-
-    // Right-trim excess 0's after the decimal point
-    int nTrim = 0;
-    for (int i = remainder_str.size()-1; i>=2 && (remainder_str.at(i) == '0'); --i)
-        ++nTrim;
-    remainder_str.chop(nTrim);
-
-    if (n < 0)
-        quotient_str.insert(0, '-');
-    else if (fPlus && n > 0)
-        quotient_str.insert(0, '+');
-    return quotient_str + QString(".") + remainder_str;
+        return 0; // Refuse to format invalid unit
+    const UnitInfo &info = unitInfo[unit];
+    quint64 n_abs = (n > 0 ? n : -(quint64)n);
+    quint64 quotient = n_abs / info.factor;
+    quint64 remainder = n_abs % info.factor;
+
+    int len = 0;
+    if(n < 0)
+        buf[len++] = '-';
+    else if(fPlus && n > 0)
+        buf[len++] = '+';
+
+    // Quotient digits are produced backwards, then copied in order
+    char digits[20];
+    int num_digits = 0;
+    do
+    {
+        digits[num_digits++] = '0' + quotient % 10;
+        quotient /= 10;
+    } while(quotient);
+    while(num_digits)
+        buf[len++] = digits[--num_digits];
+
+    buf[len++] = '.';
+    for(int i = info.decimals - 1; i >= 0; --i)
+    {
+        buf[len + i] = '0' + remainder % 10;
+        remainder /= 10;
+    }
+    // Right-trim excess 0's after the decimal point, keeping at least two decimals
+    int num_decimals = info.decimals;
+    while(num_decimals > 2 && buf[len + num_decimals - 1] == '0')
+        --num_decimals;
+    return len + num_decimals;
+}
+
+int BitcoinUnits::formatWithUnit(int unit, qint64 amount, bool plussign, QChar *buf)
+{
+    int len = format(unit, amount, plussign, buf);
+    if(!len)
+        return 0;
+    buf[len++] = ' ';
+    for(const ushort *c = unitInfo[unit].name; *c; ++c)
+        buf[len++] = *c;
+    return len;
+}
+
+QString BitcoinUnits::format(int unit, qint64 n, bool fPlus)
+{
+    QChar buf[MAX_FORMAT_LENGTH];
+    return QString(buf, format(unit, n, fPlus, buf));
 }
 
 QString BitcoinUnits::formatWithUnit(int unit, qint64 amount, bool plussign)
 {
-    return format(unit, amount, plussign) + QString(" ") + name(unit);
+    QChar buf[MAX_FORMAT_WITH_UNIT_LENGTH];
+    int len = formatWithUnit(unit, amount, plussign, buf);
+    if(!len)
+        return QString(" ") + name(unit);
+    return QString(buf, len);
 }
 
-bool BitcoinUnits::parse(int unit, const QString &value, qint64 *val_out)
+bool BitcoinUnits::parse(int unit, const QChar *str, int len, qint64 *val_out)
 {
-    if(!valid(unit) || value.isEmpty())
+    if(!valid(unit) || len == 0)
         return false; // Refuse to parse invalid unit or empty string
-    int num_decimals = decimals(unit);
-    QStringList parts = value.split(".");
+    int num_decimals = unitInfo[unit].decimals;
 
-    if(parts.size() > 2)
+    // Whitespace is rejected like any other character that is not a sign, digit or dot
+    int pos = 0, end = len;
+    bool negative = false;
+    if(pos < end && (str[pos] == '-' || str[pos] == '+'))
     {
-        return false; // More than one dot
+        negative = str[pos] == '-';
+        ++pos;
     }
-    QString whole = parts[0];
-    QString decimals;
 
-    if(parts.size() > 1)
+    qint64 value = 0;
+    int whole_len = pos; // the sign counts towards the length limit
+    int decimals_len = -1; // -1 while before the dot
+    for(; pos < end; ++pos)
     {
-        decimals = parts[1];
-    }
-    if(decimals.size() > num_decimals)
-    {
-        return false; // Exceeds max precision
+        ushort c = str[pos].unicode();
+        if(c == '.')
+        {
+            if(decimals_len >= 0)
+                return false; // More than one dot
+            decimals_len = 0;
+            continue;
+        }
+        if(c < '0' || c > '9')
+            return false;
+        if(decimals_len >= 0)
+        {
+            if(++decimals_len > num_decimals)
+                return false; // Exceeds max precision
+        }
+        else if(++whole_len + num_decimals > 18)
+        {
+            return false; // Longer numbers will exceed 63 bits
+        }
+        value = value * 10 + (c - '0');
     }
-    bool ok = false;
-    QString str = whole + decimals.leftJustified(num_decimals, '0');
+    for(int i = decimals_len < 0 ? 0 : decimals_len; i < num_decimals; ++i)
+        value *= 10;
 
-    if(str.size() > 18)
-    {
-        return false; // Longer numbers will exceed 63 bits
-    }
-    qint64 retvalue = str.toLongLong(&ok);
     if(val_out)
     {
-        *val_out = retvalue;
+        *val_out = negative ? -value : value;
     }
-    return ok;
+    return true;
+}
+
+bool BitcoinUnits::parse(int unit, const QString &value, qint64 *val_out)
+{
+    return parse(unit, value.constData(), value.size(), val_out);
 }
 
 int BitcoinUnits::rowCount(const QModelIndex &parent) const
@@ -48,6 +48,24 @@ public:
     static bool parse(int unit, const QString &value, qint64 *val_out);
     ///@}
 
+    //! @name Buffer API
+    //! Same formatting and parsing without heap allocations, for painting, sorting and exporting
+    //! large numbers of amounts
+    ///@{
+
+    //! Characters needed for a formatted amount, including sign
+    static const int MAX_FORMAT_LENGTH = 32;
+    //! Characters needed for a formatted amount with unit
+    static const int MAX_FORMAT_WITH_UNIT_LENGTH = MAX_FORMAT_LENGTH + 8;
+    //! Format into buf, which must have room for MAX_FORMAT_LENGTH characters.
+    //! Returns the number of characters written, 0 for an invalid unit.
+    static int format(int unit, qint64 amount, bool plussign, QChar *buf);
+    //! Format with unit into buf, which must have room for MAX_FORMAT_WITH_UNIT_LENGTH characters
+    static int formatWithUnit(int unit, qint64 amount, bool plussign, QChar *buf);
+    //! Parse len characters of str to coin amount
+    static bool parse(int unit, const QChar *str, int len, qint64 *val_out);
+    ///@}
+
     //! @name AbstractListModel implementation
     //! List model for unit dropdown selection box.
     ///@{
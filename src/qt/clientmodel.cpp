@@ -3,14 +3,21 @@
 #include "optionsmodel.h"
 #include "addresstablemodel.h"
 #include "transactiontablemodel.h"
+#include "synctablemodel.h"
+#include "peertablemodel.h"
 
 #include <coinChain/Node.h>
 
 #include <QTimer>
 #include <QDateTime>
+#include <QtConcurrentRun>
 
-ClientModel::ClientModel(const Node& node, OptionsModel *optionsModel, QObject *parent) :
+#include <algorithm>
+
+ClientModel::ClientModel(Node& node, OptionsModel *optionsModel, QObject *parent) :
     QObject(parent), node(node), optionsModel(optionsModel),
+    syncTableModel(new SyncTableModel(this)), peerTableModel(new PeerTableModel(node, this)),
+    sampleWatcher(new QFutureWatcher<QPair<qint64, qint64> >(this)),
     cachedNumConnections(0), cachedNumBlocks(0)
 {
     // Until signal notifications is built into the bitcoin core,
@@ -20,6 +27,21 @@ ClientModel::ClientModel(const Node& node, OptionsModel *optionsModel, QObject *
     timer->start(MODEL_UPDATE_DELAY);
 
     numBlocksAtStartup = -1;
+
+    lastSampleBlocks = getNumBlocks();
+    lastSampleMSecs = QDateTime::currentMSecsSinceEpoch();
+    sampleBlocks = lastSampleBlocks;
+    sampleMSecs = lastSampleMSecs;
+    connect(sampleWatcher, SIGNAL(finished()), this, SLOT(addSyncSample()));
+    QTimer *syncTimer = new QTimer(this);
+    connect(syncTimer, SIGNAL(timeout()), this, SLOT(sampleSync()));
+    syncTimer->start(SYNC_SAMPLE_DELAY);
+}
+
+ClientModel::~ClientModel()
+{
+    // The reader refers to the block chain, which outlives the model
+    sampleWatcher->waitForFinished();
 }
 
 int ClientModel::getNumConnections() const
@@ -57,6 +79,87 @@ void ClientModel::update()
     cachedNumBlocks = newNumBlocks;
 }
 
+/* Count transactions and bytes of the newBlocks blocks up to height numBlocks. During the initial
+   download these can be thousands, so read at most MAX_SYNC_SAMPLE_BLOCKS spread over them and
+   extrapolate. Runs on a pool thread, so that reading blocks does not stall the GUI.
+ */
+static QPair<qint64, qint64> countSyncBlocks(const BlockChain *blockChain, int numBlocks, int newBlocks)
+{
+    qint64 numTransactions = 0;
+    qint64 numBytes = 0;
+    int step = std::max(1, newBlocks / MAX_SYNC_SAMPLE_BLOCKS);
+    int numRead = 0;
+    const CBlockIndex *pindex = blockChain->getBestIndex();
+    // Blocks can have come in since the sample was taken
+    while(pindex && pindex->nHeight > numBlocks)
+        pindex = pindex->pprev;
+    for(int i = 0; pindex && i < newBlocks; ++i, pindex = pindex->pprev)
+    {
+        if(i % step)
+            continue;
+        Block block;
+        blockChain->getBlock(pindex->GetBlockHash(), block);
+        numTransactions += block.getTransactions().size();
+        numBytes += ::GetSerializeSize(block, SER_NETWORK);
+        ++numRead;
+    }
+    if(numRead)
+    {
+        numTransactions = numTransactions * newBlocks / numRead;
+        numBytes = numBytes * newBlocks / numRead;
+    }
+    return qMakePair(numTransactions, numBytes);
+}
+
+void ClientModel::sampleSync()
+{
+    // Still reading the blocks of the previous sample, the next one covers this interval as well
+    if(sampleWatcher->isRunning())
+        return;
+    sampleBlocks = getNumBlocks();
+    sampleMSecs = QDateTime::currentMSecsSinceEpoch();
+    if(sampleMSecs <= lastSampleMSecs)
+        return;
+    int newBlocks = std::max(0, sampleBlocks - lastSampleBlocks);
+    sampleWatcher->setFuture(QtConcurrent::run(countSyncBlocks, &node.blockChain(), sampleBlocks, newBlocks));
+}
+
+void ClientModel::addSyncSample()
+{
+    int numBlocks = sampleBlocks;
+    qint64 nowMSecs = sampleMSecs;
+    double seconds = (nowMSecs - lastSampleMSecs) / 1000.0;
+    int newBlocks = numBlocks - lastSampleBlocks;
+    qint64 numTransactions = sampleWatcher->result().first;
+    qint64 numBytes = sampleWatcher->result().second;
+
+    SyncSample sample;
+    sample.time = QDateTime::fromMSecsSinceEpoch(nowMSecs);
+    sample.numBlocks = numBlocks;
+    sample.numBlocksOfPeers = getNumBlocksOfPeers();
+    syncEstimator.estimate(sample, newBlocks, numTransactions, numBytes, seconds);
+
+    syncTableModel->addSample(sample);
+
+    lastSampleBlocks = numBlocks;
+    lastSampleMSecs = nowMSecs;
+}
+
+SyncTableModel *ClientModel::getSyncTableModel()
+{
+    return syncTableModel;
+}
+
+void ClientModel::addMemoryUsage(MemoryUsage &usage) const
+{
+    MemoryAccounting::addBlockIndex(usage, getNumBlocks());
+}
+
+PeerTableModel *ClientModel::getPeerTableModel()
+{
+    return peerTableModel;
+}
+
 bool ClientModel::isTestNet() const
 {
     return node.blockChain().chain().dataDirSuffix() == "bitcoin/testnet";
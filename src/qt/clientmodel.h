@@ -2,10 +2,16 @@
 #define CLIENTMODEL_H
 
 #include <QObject>
+#include <QPair>
+#include <QFutureWatcher>
+
+#include "memoryusage.h"
+#include "synctablemodel.h"
 
 class OptionsModel;
 class AddressTableModel;
 class TransactionTableModel;
+class PeerTableModel;
 class Node;
 class Wallet;
 
@@ -18,7 +24,8 @@ class ClientModel : public QObject
 {
     Q_OBJECT
 public:
-    explicit ClientModel(const Node& node, OptionsModel *optionsModel, QObject *parent = 0);
+    explicit ClientModel(Node& node, OptionsModel *optionsModel, QObject *parent = 0);
+    ~ClientModel();
 
     OptionsModel *getOptionsModel();
 
@@ -39,9 +46,28 @@ public:
 
     QString formatFullVersion() const;
 
+    //! Time series of synchronization throughput, sampled every SYNC_SAMPLE_DELAY
+    SyncTableModel *getSyncTableModel();
+    //! Statistics of the connected peers
+    PeerTableModel *getPeerTableModel();
+
+    //! Add the estimated memory used by the block index
+    void addMemoryUsage(MemoryUsage &usage) const;
+
 private:
-    const Node& node;
+    Node& node;
     OptionsModel *optionsModel;
+    SyncTableModel *syncTableModel;
+    PeerTableModel *peerTableModel;
+
+    int lastSampleBlocks;
+    qint64 lastSampleMSecs;
+    SyncEstimator syncEstimator;
+    // Sample whose blocks are being read in the background: height, time and the
+    // number of transactions and bytes read
+    int sampleBlocks;
+    qint64 sampleMSecs;
+    QFutureWatcher<QPair<qint64, qint64> > *sampleWatcher;
 
     int cachedNumConnections;
     int cachedNumBlocks;
@@ -59,6 +85,8 @@ public slots:
 
 private slots:
     void update();
+    void sampleSync();
+    void addSyncSample();
 };
 
 #endif // CLIENTMODEL_H
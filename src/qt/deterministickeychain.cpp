@@ -0,0 +1,283 @@
+#include "deterministickeychain.h"
+
+#include <coinWallet/Wallet.h>
+#include <coinWallet/WalletDB.h>
+
+#include <openssl/sha.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <map>
+#include <cstring>
+
+/* Wallet settings of the chain */
+static const char *SETTING_SEED = "vchDeterministicSeed";
+static const char *SETTING_NEXT = "nDeterministicNext";
+static const char *SETTING_DERIVED = "nDeterministicDerived";
+
+/* Order of the secp256k1 group, secrets must be below it */
+static const unsigned char CURVE_ORDER[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41
+};
+
+static bool isValidSecret(const unsigned char *secret)
+{
+    static const unsigned char zero[32] = {};
+    return memcmp(secret, zero, 32) != 0 && memcmp(secret, CURVE_ORDER, 32) < 0;
+}
+
+/* Hashes are uniformly distributed already. Not static, QHash finds it by argument dependent lookup. */
+inline uint qHash(const uint160 &hash)
+{
+    uint160 copy(hash);
+    uint result;
+    memcpy(&result, copy.begin(), sizeof(result));
+    return result;
+}
+
+DeterministicKeyChain::DeterministicKeyChain(Wallet *wallet, const std::vector<unsigned char> &seed):
+    wallet(wallet), seed(seed), nLookahead(DEFAULT_LOOKAHEAD), nWindowBegin(0), nWindowEnd(0)
+{
+}
+
+DeterministicKeyChain *DeterministicKeyChain::load(Wallet *wallet)
+{
+    std::vector<unsigned char> seed;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(wallet->IsCrypted() || !walletdb.ReadSetting(SETTING_SEED, seed) || seed.size() != SEED_SIZE)
+            return 0;
+    }
+    return new DeterministicKeyChain(wallet, seed);
+}
+
+bool DeterministicKeyChain::init(Wallet *wallet)
+{
+    std::vector<unsigned char> seed(SEED_SIZE);
+    if(!RAND_bytes(&seed[0], SEED_SIZE))
+        return false;
+
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        std::vector<unsigned char> existing;
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(wallet->IsCrypted() || walletdb.ReadSetting(SETTING_SEED, existing))
+            return false;
+        if(!walletdb.WriteSetting(SETTING_SEED, seed))
+            return false;
+        DeterministicKeyChain chain(wallet, seed);
+        chain.storeKeys(chain.nLookahead, 0);
+        return true;
+    }
+    return false;
+}
+
+DeterministicKeyChain *DeterministicKeyChain::create(Wallet *wallet)
+{
+    return init(wallet) ? load(wallet) : 0;
+}
+
+bool DeterministicKeyChain::remove(Wallet *wallet)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(!walletdb.EraseSetting(SETTING_SEED))
+            return false;
+    }
+    // Erasing only unlinks the record, rewrite the file the way encryption does to get rid of the
+    // unencrypted keys. Outside the wallet lock, as the rewrite waits for the file to be closed.
+    return CDB::Rewrite(wallet->strWalletFile);
+}
+
+bool DeterministicKeyChain::isEnabled(Wallet *wallet)
+{
+    std::vector<unsigned char> seed;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        return !wallet->IsCrypted() && walletdb.ReadSetting(SETTING_SEED, seed);
+    }
+    return false;
+}
+
+void DeterministicKeyChain::setLookahead(int window)
+{
+    nLookahead = std::max(1, window);
+}
+
+bool DeterministicKeyChain::deriveKey(quint32 index, CKey &key) const
+{
+    // seed || index || counter, the counter only changes in the unlikely case that the hash is no valid secret
+    unsigned char data[SEED_SIZE + 8];
+    memcpy(data, &seed[0], SEED_SIZE);
+    for(int i = 0; i < 4; ++i)
+        data[SEED_SIZE + i] = (unsigned char)(index >> (8 * i));
+
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    unsigned char secret[SHA256_DIGEST_LENGTH];
+    for(quint32 counter = 0; ; ++counter)
+    {
+        for(int i = 0; i < 4; ++i)
+            data[SEED_SIZE + 4 + i] = (unsigned char)(counter >> (8 * i));
+        SHA256(data, sizeof(data), hash);
+        SHA256(hash, sizeof(hash), secret);
+        if(isValidSecret(secret))
+            break;
+    }
+
+    CSecret vchSecret(secret, secret + sizeof(secret));
+    OPENSSL_cleanse(data, sizeof(data));
+    OPENSSL_cleanse(hash, sizeof(hash));
+    OPENSSL_cleanse(secret, sizeof(secret));
+    return key.SetSecret(vchSecret);
+}
+
+void DeterministicKeyChain::updateWindow(quint32 next, quint32 derived)
+{
+    // Keys handed out since the last update no longer move the window
+    if(next > nWindowBegin)
+    {
+        QMutableHashIterator<uint160, quint32> it(window);
+        while(it.hasNext())
+        {
+            if(it.next().value() < next)
+                it.remove();
+        }
+        nWindowBegin = next;
+    }
+    for(quint32 index = std::max(nWindowEnd, nWindowBegin); index < derived; ++index)
+    {
+        CKey key;
+        if(deriveKey(index, key))
+            window.insert(toPubKeyHash(key.GetPubKey()), index);
+    }
+    nWindowEnd = std::max(nWindowEnd, derived);
+}
+
+bool DeterministicKeyChain::storeKeys(quint32 end, quint32 next)
+{
+    CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+    int64 nDerived = 0;
+    walletdb.ReadSetting(SETTING_DERIVED, nDerived);
+
+    std::vector<CKey> keys;
+    for(quint32 index = (quint32)nDerived; index < end; ++index)
+    {
+        CKey key;
+        if(!deriveKey(index, key))
+            return false;
+        keys.push_back(key);
+    }
+
+    if(!walletdb.TxnBegin())
+        return false;
+    BOOST_FOREACH(const CKey &key, keys)
+    {
+        if(!walletdb.WriteKey(key.GetPubKey(), key.GetPrivKey()))
+        {
+            walletdb.TxnAbort();
+            return false;
+        }
+    }
+    if(!walletdb.WriteSetting(SETTING_DERIVED, (int64)std::max((quint32)nDerived, end)) ||
+       !walletdb.WriteSetting(SETTING_NEXT, (int64)next))
+    {
+        walletdb.TxnAbort();
+        return false;
+    }
+    if(!walletdb.TxnCommit())
+        return false;
+
+    // A key in the key store but not in the file would be lost on a restart, payments to it included
+    bool fAdded = true;
+    quint32 index = (quint32)nDerived;
+    BOOST_FOREACH(const CKey &key, keys)
+    {
+        if(!wallet->CCryptoKeyStore::AddKey(key))
+            fAdded = false;
+        // Extend the window index with the keys just derived, if it reaches up to them
+        if(index == nWindowEnd && index >= nWindowBegin)
+        {
+            window.insert(toPubKeyHash(key.GetPubKey()), index);
+            nWindowEnd = index + 1;
+        }
+        ++index;
+    }
+    return fAdded;
+}
+
+bool DeterministicKeyChain::getNewKey(std::vector<unsigned char> &pubKey)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        // Encrypting the wallet removes the seed, but this instance may still have it
+        if(wallet->IsCrypted())
+            return false;
+
+        int64 nNext = 0;
+        {
+            CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+            walletdb.ReadSetting(SETTING_NEXT, nNext);
+        }
+        CKey key;
+        if(!deriveKey((quint32)nNext, key))
+            return false;
+        // Stores the key itself too, in case the window was not filled yet
+        if(!storeKeys((quint32)nNext + 1 + nLookahead, (quint32)nNext + 1))
+            return false;
+        pubKey = key.GetPubKey();
+        return true;
+    }
+    return false;
+}
+
+int DeterministicKeyChain::advancePastUsed(const QList<uint256> &updated)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        if(wallet->IsCrypted() || updated.isEmpty())
+            return 0;
+
+        int64 nNext = 0, nDerived = 0;
+        {
+            CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+            walletdb.ReadSetting(SETTING_NEXT, nNext);
+            walletdb.ReadSetting(SETTING_DERIVED, nDerived);
+        }
+        if(nNext >= nDerived)
+            return 0;
+        updateWindow((quint32)nNext, (quint32)nDerived);
+
+        // Only the outputs of the updated transactions can pay to a key that was not used before
+        int64 nUsed = -1;
+        BOOST_FOREACH(const uint256 &hash, updated)
+        {
+            std::map<uint256, CWalletTx>::const_iterator it = wallet->mapWallet.find(hash);
+            if(it == wallet->mapWallet.end())
+                continue;
+            BOOST_FOREACH(const Output& txout, it->second.getOutputs())
+            {
+                PubKeyHash pubKeyHash;
+                ScriptHash scriptHash;
+                if(!ExtractAddress(txout.script(), pubKeyHash, scriptHash))
+                    continue;
+                QHash<uint160, quint32>::const_iterator mi = window.find(pubKeyHash);
+                if(mi != window.end() && mi.value() >= nNext)
+                    nUsed = std::max(nUsed, (int64)mi.value());
+            }
+        }
+        if(nUsed < 0)
+            return 0;
+
+        if(!storeKeys((quint32)nUsed + 1 + nLookahead, (quint32)nUsed + 1))
+            return 0;
+        return (int)(nUsed + 1 - nNext);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef DETERMINISTICKEYCHAIN_H
+#define DETERMINISTICKEYCHAIN_H
+
+#include <QHash>
+#include <QList>
+
+#include <coin/uint256.h>
+
+#include <vector>
+
+class Wallet;
+class CKey;
+
+/** Receiving keys derived from a seed stored in the wallet, instead of the random keys of the key pool.
+    Key i has secret SHA256(SHA256(seed || i)), so a backup taken once covers every receiving address the
+    GUI hands out after it, and a new key costs one derivation rather than a key pool refill. Change
+    outputs and RPC getnewaddress still take random keys from the key pool, which a backup only covers
+    up to the pool keys it contains.
+
+    A window of keys past the last handed out key is kept in the wallet, so that a rescan of a restored
+    backup finds payments to addresses that were handed out after the backup was taken. The seed is only
+    kept in unencrypted wallets, encrypting a wallet removes it and new keys come from the pool again.
+
+    The next index and the number of stored keys live in the wallet file. All calls take the wallet lock.
+ */
+class DeterministicKeyChain
+{
+public:
+    static const int SEED_SIZE = 32;
+    /** Keys kept in the wallet past the last key handed out */
+    static const int DEFAULT_LOOKAHEAD = 100;
+
+    /** Chain of a wallet that has a seed, 0 otherwise. The caller owns the result. */
+    static DeterministicKeyChain *load(Wallet *wallet);
+    /** Add a random seed to a new unencrypted wallet, and store the first window of keys.
+        Returns false if the wallet is encrypted or already has a seed.
+     */
+    static bool init(Wallet *wallet);
+    /** init(), and return the chain of the wallet, or 0 if it could not be set up. The caller owns the result. */
+    static DeterministicKeyChain *create(Wallet *wallet);
+    /** Erase the seed of a wallet and rewrite the wallet file, so that the seed does not remain in free
+        database pages. The keys derived so far stay in the wallet.
+     */
+    static bool remove(Wallet *wallet);
+    static bool isEnabled(Wallet *wallet);
+
+    int getLookahead() const { return nLookahead; }
+    void setLookahead(int window);
+
+    /** Derive the key at index, without adding it to the wallet */
+    bool deriveKey(quint32 index, CKey &key) const;
+    /** Hand out the next key, and extend the window of stored keys past it. Returns false if the wallet
+        no longer has a seed or the keys could not be written, in which case the key pool should be used.
+     */
+    bool getNewKey(std::vector<unsigned char> &pubKey);
+    /** Skip the keys up to the last one in the window that received a payment from one of the updated
+        wallet transactions, for instance found by a rescan, and extend the window past it. Returns the
+        number of keys skipped.
+     */
+    int advancePastUsed(const QList<uint256> &updated);
+
+private:
+    explicit DeterministicKeyChain(Wallet *wallet, const std::vector<unsigned char> &seed);
+
+    Wallet *wallet;
+    std::vector<unsigned char> seed;
+    int nLookahead;
+
+    /* Index of the keys of the window by public key hash, so that matching a payment does not take a
+       derivation per key. Covers the keys from nWindowBegin to nWindowEnd, and may still hold keys
+       before the next index, which was possibly moved on by another instance for the same wallet.
+     */
+    QHash<uint160, quint32> window;
+    quint32 nWindowBegin;
+    quint32 nWindowEnd;
+
+    /** Bring the window index in line with the next index and stored keys. Call with the wallet locked. */
+    void updateWindow(quint32 next, quint32 derived);
+    /** Store keys up to end and the next index, in one wallet transaction. The keys are only added to
+        the key store once the transaction is committed. Call with the wallet locked.
+     */
+    bool storeKeys(quint32 end, quint32 next);
+};
+
+#endif // DETERMINISTICKEYCHAIN_H
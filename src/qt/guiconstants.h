@@ -4,6 +4,20 @@
 /* Milliseconds between model updates */
 static const int MODEL_UPDATE_DELAY = 500;
 
+/* Milliseconds between refreshes of the peer table while it is shown */
+static const int PEER_UPDATE_DELAY = 2000;
+
+/* Milliseconds between samples of the synchronization progress */
+static const int SYNC_SAMPLE_DELAY = 5000;
+/* Number of synchronization samples kept, one hour at the default delay */
+static const int MAX_SYNC_SAMPLES = 720;
+/* Blocks read per sample to count transactions and bytes, more are extrapolated */
+static const int MAX_SYNC_SAMPLE_BLOCKS = 50;
+
+/* Milliseconds after the main window is created before the pages that were not
+   visited yet are created in the background */
+static const int PAGE_CREATE_DELAY = 1000;
+
 /* Maximum  passphrase length */
 static const int MAX_PASSPHRASE_SIZE = 1024;
 
@@ -133,3 +133,82 @@ void GUIUtil::copyEntryData(QAbstractItemView *view, int column, int role)
         QApplication::clipboard()->setText(selection.at(0).data(role).toString());
     }
 }
+
+// Unquoted fields are trimmed, quoted fields are taken as they are
+static QString csvField(const QString &field, bool quoted)
+{
+    return quoted ? field : field.trimmed();
+}
+
+bool GUIUtil::parseCSV(const QString &data, QList<QStringList> &records, QList<int> *lines)
+{
+    QStringList record;
+    QString field;
+    bool quoted = false;
+    // Field started with a quote, whitespace around the quotes is not part of it
+    bool fieldQuoted = false;
+    int line = 1;
+    int recordLine = 1;
+    const int size = data.size();
+    for(int i = 0; i < size; ++i)
+    {
+        QChar c = data.at(i);
+        if(quoted)
+        {
+            if(c == '\n')
+                ++line;
+            if(c != '"')
+                field.append(c);
+            else if(i + 1 < size && data.at(i + 1) == '"')
+                field.append(data.at(++i));
+            else
+                quoted = false;
+        }
+        else if(c == '"' && !fieldQuoted && field.trimmed().isEmpty())
+        {
+            quoted = true;
+            fieldQuoted = true;
+            field.clear();
+        }
+        else if(c == ',')
+        {
+            record.append(csvField(field, fieldQuoted));
+            field.clear();
+            fieldQuoted = false;
+        }
+        else if(c == '\n' || c == '\r')
+        {
+            if(fieldQuoted || !field.isEmpty() || !record.isEmpty())
+            {
+                record.append(csvField(field, fieldQuoted));
+                records.append(record);
+                if(lines)
+                    lines->append(recordLine);
+            }
+            record.clear();
+            field.clear();
+            fieldQuoted = false;
+            if(c == '\n')
+                ++line;
+            recordLine = line;
+        }
+        else if(!fieldQuoted || !c.isSpace())
+        {
+            field.append(c);
+        }
+    }
+    if(quoted)
+    {
+        if(lines)
+            lines->append(recordLine);
+        return false;
+    }
+    if(fieldQuoted || !field.isEmpty() || !record.isEmpty())
+    {
+        record.append(csvField(field, fieldQuoted));
+        records.append(record);
+        if(lines)
+            lines->append(recordLine);
+    }
+    return true;
+}
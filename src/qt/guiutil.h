@@ -2,6 +2,7 @@
 #define GUIUTIL_H
 
 #include <QString>
+#include <QStringList>
 
 QT_BEGIN_NAMESPACE
 class QFont;
@@ -46,6 +47,15 @@ public:
      */
     static void copyEntryData(QAbstractItemView *view, int column, int role=Qt::EditRole);
 
+    /** Split CSV data into records of fields. Fields may be quoted, with "" for a quote inside a
+        quoted field, so that they can contain separators and line breaks.
+       @param[out] lines  If given, the line each record starts on, counting from 1. Differs from the
+                          record index when there are blank lines or line breaks inside quoted fields.
+                          On failure the last line is that of the record with the unterminated field.
+       @returns false if a quoted field is not terminated
+     */
+    static bool parseCSV(const QString &data, QList<QStringList> &records, QList<int> *lines=0);
+
 };
 
 #endif // GUIUTIL_H
@@ -0,0 +1,169 @@
+#include "keypoolrefiller.h"
+
+#include <coinWallet/Wallet.h>
+#include <coinWallet/WalletDB.h>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <vector>
+
+/* Keys generated and written per wallet transaction. Bounds the time the wallet lock is held
+   by the refiller.
+ */
+static const int KEYPOOL_BATCH_SIZE = 20;
+
+/* Milliseconds between checks of the pool size, when nothing wakes the refiller earlier */
+static const unsigned long KEYPOOL_CHECK_DELAY = 1000;
+
+// Worker: generate a range of keys
+static void generateKeys(std::vector<CKey> *keys, int begin, int end)
+{
+    for(int idx = begin; idx < end; ++idx)
+        keys->at(idx).MakeNewKey();
+}
+
+KeyPoolRefiller::KeyPoolRefiller(Wallet *wallet, int targetSize, QObject *parent):
+    QThread(parent), wallet(wallet), numThreads(boost::thread::hardware_concurrency()),
+    targetSize(targetSize), fWoken(true), fStopped(false)
+{
+    if(numThreads < 1)
+        numThreads = 1;
+}
+
+KeyPoolRefiller::~KeyPoolRefiller()
+{
+    stop();
+    wait();
+}
+
+void KeyPoolRefiller::setNumThreads(int threads)
+{
+    numThreads = threads < 1 ? 1 : threads;
+}
+
+int KeyPoolRefiller::getTargetSize() const
+{
+    QMutexLocker lock(&mutex);
+    return targetSize;
+}
+
+void KeyPoolRefiller::setTargetSize(int size)
+{
+    QMutexLocker lock(&mutex);
+    targetSize = size;
+    fWoken = true;
+    woken.wakeAll();
+}
+
+void KeyPoolRefiller::wake()
+{
+    QMutexLocker lock(&mutex);
+    fWoken = true;
+    woken.wakeAll();
+}
+
+void KeyPoolRefiller::stop()
+{
+    QMutexLocker lock(&mutex);
+    fStopped = true;
+    woken.wakeAll();
+}
+
+bool KeyPoolRefiller::waitForCheck()
+{
+    QMutexLocker lock(&mutex);
+    if(!fWoken && !fStopped)
+        woken.wait(&mutex, KEYPOOL_CHECK_DELAY);
+    fWoken = false;
+    return !fStopped;
+}
+
+int KeyPoolRefiller::addKeys(Wallet *wallet, int count, int numThreads)
+{
+    if(count <= 0)
+        return 0;
+
+    // Key generation is the expensive part, so do it in parallel and before taking the wallet lock
+    std::vector<CKey> keys(count);
+    int perWorker = (count + numThreads - 1) / numThreads;
+    boost::thread_group workers;
+    for(int begin = 0; begin < count; begin += perWorker)
+        workers.create_thread(boost::bind(&generateKeys, &keys, begin, std::min(count, begin + perWorker)));
+    workers.join_all();
+
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        // The keys can only be encrypted while the master key is available
+        if(wallet->IsLocked())
+            return 0;
+
+        // AddKey encrypts the key if the wallet is encrypted, and writes it to the wallet file. A key
+        // that is stored but not in the pool is merely unused, so the keys go first.
+        std::vector<const CKey*> vStored;
+        BOOST_FOREACH(const CKey &key, keys)
+        {
+            if(!wallet->AddKey(key))
+                break;
+            vStored.push_back(&key);
+        }
+        if(vStored.empty())
+            return 0;
+
+        // The pool entries of the batch are written in a single transaction
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(!walletdb.TxnBegin())
+            return 0;
+        int64 nIndex = wallet->setKeyPool.empty() ? 1 : *wallet->setKeyPool.rbegin() + 1;
+        std::vector<int64> vIndexes;
+        BOOST_FOREACH(const CKey *key, vStored)
+        {
+            if(!walletdb.WritePool(nIndex, CKeyPool(key->GetPubKey())))
+            {
+                walletdb.TxnAbort();
+                return 0;
+            }
+            vIndexes.push_back(nIndex++);
+        }
+        if(!walletdb.TxnCommit())
+            return 0;
+
+        // Only offer the keys once they are on disk
+        wallet->setKeyPool.insert(vIndexes.begin(), vIndexes.end());
+        return (int)vIndexes.size();
+    }
+    return 0;
+}
+
+void KeyPoolRefiller::run()
+{
+    while(waitForCheck())
+    {
+        // Never wait for the wallet lock just to look at the pool, there is another check soon
+        int missing = 0;
+        TRY_CRITICAL_BLOCK(wallet->cs_wallet)
+        {
+            if(!wallet->IsLocked())
+                missing = getTargetSize() - (int)wallet->setKeyPool.size();
+        }
+        // Wallets with a seed (DeterministicKeyChain) are refilled too, change and RPC addresses
+        // still come from the pool
+        if(missing <= 0)
+            continue;
+
+        int added = addKeys(wallet, std::min(missing, KEYPOOL_BATCH_SIZE), numThreads);
+        if(added <= 0)
+            continue;
+
+        int poolSize = 0;
+        CRITICAL_BLOCK(wallet->cs_wallet)
+            poolSize = (int)wallet->setKeyPool.size();
+        emit refilled(poolSize);
+
+        // Go on with the next batch right away, other threads get the wallet lock in between
+        if(added < missing)
+            wake();
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef KEYPOOLREFILLER_H
+#define KEYPOOLREFILLER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+class Wallet;
+
+/** Keeps the key pool of a wallet topped up in the background, so that handing out a new
+    receiving address only takes a key from the pool and never generates one on the GUI thread.
+
+    Keys are generated in batches, in parallel and outside of the wallet lock, and the pool entries
+    of each batch are written to the wallet file in a single transaction. A locked wallet cannot store new keys, so
+    refilling waits until the wallet is unlocked. Wallets that derive their receiving keys from a
+    seed (DeterministicKeyChain) still take change keys from the pool, so they are refilled too.
+ */
+class KeyPoolRefiller : public QThread
+{
+    Q_OBJECT
+public:
+    /** Number of keys kept in the pool when -keypool is not given */
+    static const int DEFAULT_TARGET_SIZE = 100;
+
+    explicit KeyPoolRefiller(Wallet *wallet, int targetSize = DEFAULT_TARGET_SIZE, QObject *parent = 0);
+    /** Stops the refiller, and waits for the batch being written to finish. */
+    ~KeyPoolRefiller();
+
+    /** Set number of key generation threads, defaults to the number of cores. */
+    void setNumThreads(int threads);
+
+    int getTargetSize() const;
+    void setTargetSize(int size);
+
+    /** Generate and store up to count keys in one go, on the calling thread.
+        Returns the number of keys added to the pool.
+     */
+    static int addKeys(Wallet *wallet, int count, int numThreads = 1);
+
+public slots:
+    /** Check the pool right away, for instance after the wallet was unlocked or a key was taken */
+    void wake();
+    void stop();
+
+signals:
+    /** A batch of keys was added, the pool now holds poolSize keys */
+    void refilled(int poolSize);
+
+protected:
+    void run();
+
+private:
+    Wallet *wallet;
+    int numThreads;
+
+    mutable QMutex mutex;
+    QWaitCondition woken;
+    int targetSize;
+    bool fWoken;
+    bool fStopped;
+
+    /** Wait for the next check, return false when the refiller should stop. */
+    bool waitForCheck();
+};
+
+#endif // KEYPOOLREFILLER_H
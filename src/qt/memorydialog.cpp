@@ -0,0 +1,63 @@
+#include "memorydialog.h"
+#include "ui_memorydialog.h"
+#include "memoryusage.h"
+
+#include <QHeaderView>
+
+MemoryDialog::MemoryDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::MemoryDialog),
+    clientModel(0),
+    walletManager(0)
+{
+    ui->setupUi(this);
+
+    ui->tableWidget->setColumnCount(3);
+    ui->tableWidget->setHorizontalHeaderLabels(QStringList() << tr("Structure") << tr("Elements") << tr("Size (kB)"));
+    ui->tableWidget->horizontalHeader()->setResizeMode(0, QHeaderView::Stretch);
+}
+
+MemoryDialog::~MemoryDialog()
+{
+    delete ui;
+}
+
+void MemoryDialog::setModels(ClientModel *clientModel, WalletManager *walletManager)
+{
+    this->clientModel = clientModel;
+    this->walletManager = walletManager;
+    on_refreshButton_clicked();
+}
+
+void MemoryDialog::on_refreshButton_clicked()
+{
+    MemoryUsage usage = MemoryAccounting::collect(clientModel, walletManager);
+
+    ui->tableWidget->setRowCount(usage.size() + 1);
+    int row = 0;
+    foreach(const MemoryUsageEntry &entry, usage)
+    {
+        ui->tableWidget->setItem(row, 0, new QTableWidgetItem(entry.name));
+        QTableWidgetItem *count = new QTableWidgetItem(entry.count < 0 ? QString() : QString::number(entry.count));
+        count->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+        ui->tableWidget->setItem(row, 1, count);
+        // Limits are not counted in the total, mark them so the column still adds up
+        QTableWidgetItem *size = new QTableWidgetItem((entry.limit ? QString("<= ") : QString()) + QString::number(entry.bytes / 1024));
+        size->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+        if(entry.limit)
+            size->setToolTip(tr("Upper limit, not included in the total"));
+        ui->tableWidget->setItem(row, 2, size);
+        ++row;
+    }
+
+    QTableWidgetItem *totalLabel = new QTableWidgetItem(tr("Total"));
+    QFont bold = totalLabel->font();
+    bold.setBold(true);
+    totalLabel->setFont(bold);
+    ui->tableWidget->setItem(row, 0, totalLabel);
+    ui->tableWidget->setItem(row, 1, new QTableWidgetItem());
+    QTableWidgetItem *totalSize = new QTableWidgetItem(QString::number(MemoryAccounting::total(usage) / 1024));
+    totalSize->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    totalSize->setFont(bold);
+    ui->tableWidget->setItem(row, 2, totalSize);
+}
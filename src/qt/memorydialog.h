@@ -0,0 +1,33 @@
+#ifndef MEMORYDIALOG_H
+#define MEMORYDIALOG_H
+
+#include <QDialog>
+
+namespace Ui {
+    class MemoryDialog;
+}
+class ClientModel;
+class WalletManager;
+
+/** Debug window with the approximate memory used by the main caches and core structures.
+ */
+class MemoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryDialog(QWidget *parent = 0);
+    ~MemoryDialog();
+
+    void setModels(ClientModel *clientModel, WalletManager *walletManager);
+
+private:
+    Ui::MemoryDialog *ui;
+    ClientModel *clientModel;
+    WalletManager *walletManager;
+
+private slots:
+    void on_refreshButton_clicked();
+};
+
+#endif // MEMORYDIALOG_H
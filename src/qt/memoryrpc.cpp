@@ -0,0 +1,35 @@
+#include "memoryrpc.h"
+#include "memoryusage.h"
+
+#include <coinChain/Node.h>
+#include <coinWallet/Wallet.h>
+#include <coinHTTP/RPC.h>
+
+using namespace json_spirit;
+
+Value GetMemoryUsage::operator()(const Array &params, bool fHelp)
+{
+    if(fHelp || params.size() != 0)
+        throw RPC::error(RPC::invalid_params, "getmemoryusage\n"
+                         "Returns the estimated memory used by the wallet transactions and the block index,\n"
+                         "as {structures: [{name, count, bytes}, ...], total}.");
+
+    MemoryUsage usage;
+    MemoryAccounting::addWallet(usage, &_wallet, QString::fromStdString(_wallet.strWalletFile));
+    MemoryAccounting::addBlockIndex(usage, _node.blockChain().getBestHeight());
+
+    Array structures;
+    foreach(const MemoryUsageEntry &entry, usage)
+    {
+        Object structure;
+        structure.push_back(Pair("name", entry.name.toStdString()));
+        structure.push_back(Pair("count", (boost::int64_t)entry.count));
+        structure.push_back(Pair("bytes", (boost::int64_t)entry.bytes));
+        structures.push_back(structure);
+    }
+
+    Object result;
+    result.push_back(Pair("structures", structures));
+    result.push_back(Pair("total", (boost::int64_t)MemoryAccounting::total(usage)));
+    return result;
+}
@@ -0,0 +1,24 @@
+#ifndef MEMORYRPC_H
+#define MEMORYRPC_H
+
+#include <coinHTTP/Server.h>
+
+class Node;
+class Wallet;
+
+/** getmemoryusage
+    Estimated memory used by the wallet transactions and the block index, see MemoryAccounting.
+    The GUI caches belong to the GUI thread and are only shown in Help > Memory Usage.
+ */
+class GetMemoryUsage : public Method
+{
+public:
+    GetMemoryUsage(Node &node, Wallet &wallet) : _node(node), _wallet(wallet) {}
+    json_spirit::Value operator()(const json_spirit::Array &params, bool fHelp);
+
+private:
+    Node &_node;
+    Wallet &_wallet;
+};
+
+#endif // MEMORYRPC_H
@@ -0,0 +1,136 @@
+#include "memoryusage.h"
+#include "clientmodel.h"
+#include "walletmanager.h"
+
+#include <coinWallet/Wallet.h>
+
+#include <QPixmapCache>
+#include <QSocketNotifier>
+#include <QStringList>
+
+#ifndef WIN32
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+void MemoryAccounting::addQtCaches(MemoryUsage &usage)
+{
+    // Qt does not report the current size of the pixmap cache, only its limit
+    usage.append(MemoryUsageEntry(QObject::tr("Pixmap cache (limit)"), -1, (qint64)QPixmapCache::cacheLimit() * 1024, true));
+}
+
+void MemoryAccounting::addWallet(MemoryUsage &usage, Wallet *wallet, const QString &walletName)
+{
+    qint64 count = 0;
+    qint64 bytes = 0;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        count = wallet->mapWallet.size();
+        for(std::map<uint256, CWalletTx>::const_iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
+        {
+            // The serialized size approximates the inputs, outputs and merkle branch held by the transaction
+            bytes += sizeof(*it) + MAP_NODE_OVERHEAD + ::GetSerializeSize(it->second, SER_DISK);
+        }
+    }
+    usage.append(MemoryUsageEntry(QObject::tr("%1: wallet transactions").arg(walletName), count, bytes));
+}
+
+void MemoryAccounting::addBlockIndex(MemoryUsage &usage, int bestHeight)
+{
+    // Counts the best chain only, blocks on side chains are also kept in the index
+    qint64 count = bestHeight + 1;
+    qint64 bytes = count * (sizeof(uint256) + sizeof(CBlockIndex) + MAP_NODE_OVERHEAD);
+    usage.append(MemoryUsageEntry(QObject::tr("Block index (best chain)"), count, bytes));
+}
+
+qint64 MemoryAccounting::total(const MemoryUsage &usage)
+{
+    qint64 total = 0;
+    foreach(const MemoryUsageEntry &entry, usage)
+    {
+        if(!entry.limit)
+            total += entry.bytes;
+    }
+    return total;
+}
+
+MemoryUsage MemoryAccounting::collect(const ClientModel *clientModel, WalletManager *walletManager)
+{
+    MemoryUsage usage;
+    if(clientModel)
+        clientModel->addMemoryUsage(usage);
+    if(walletManager)
+        walletManager->addMemoryUsage(usage);
+    addQtCaches(usage);
+    return usage;
+}
+
+QString MemoryAccounting::format(const MemoryUsage &usage)
+{
+    QStringList lines;
+    foreach(const MemoryUsageEntry &entry, usage)
+    {
+        lines.append(QString("%1 %2 %3")
+                     .arg(entry.name, -32)
+                     .arg(entry.count < 0 ? QString("-") : QString::number(entry.count), 10)
+                     .arg((entry.limit ? "<= " : "") + QString::number(entry.bytes / 1024) + " kB", 12));
+    }
+    lines.append(QString("%1 %2 %3").arg(QObject::tr("Total"), -32).arg(QString(), 10)
+                 .arg(QString::number(total(usage) / 1024) + " kB", 12));
+    return lines.join("\n");
+}
+
+#ifndef WIN32
+// Socket pair to get from the signal handler into the event loop, see
+// "Calling Qt Functions From Unix Signal Handlers" in the Qt documentation.
+static int signalFd[2] = { -1, -1 };
+
+static void usr1Handler(int)
+{
+    char a = 1;
+    ssize_t ret = ::write(signalFd[0], &a, sizeof(a));
+    (void)ret;
+}
+#endif
+
+MemoryUsageSignal::MemoryUsageSignal(QObject *parent) :
+    QObject(parent), notifier(0)
+{
+#ifndef WIN32
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFd))
+        return;
+    notifier = new QSocketNotifier(signalFd[1], QSocketNotifier::Read, this);
+    connect(notifier, SIGNAL(activated(int)), this, SLOT(handleSignal()));
+
+    struct sigaction usr1;
+    usr1.sa_handler = usr1Handler;
+    sigemptyset(&usr1.sa_mask);
+    usr1.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &usr1, 0);
+#endif
+}
+
+MemoryUsageSignal::~MemoryUsageSignal()
+{
+#ifndef WIN32
+    if(notifier)
+    {
+        signal(SIGUSR1, SIG_DFL);
+        ::close(signalFd[0]);
+        ::close(signalFd[1]);
+    }
+#endif
+}
+
+void MemoryUsageSignal::handleSignal()
+{
+#ifndef WIN32
+    notifier->setEnabled(false);
+    char a;
+    ssize_t ret = ::read(signalFd[1], &a, sizeof(a));
+    (void)ret;
+    notifier->setEnabled(true);
+#endif
+    emit requested();
+}
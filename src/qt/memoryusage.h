@@ -0,0 +1,80 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+
+class ClientModel;
+class WalletManager;
+class Wallet;
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+/** Approximate memory used by one structure: number of elements and estimated bytes,
+    including the dynamic allocations of the elements as far as they are known.
+    For a limit, bytes is the most the structure may use and it is left out of totals.
+ */
+struct MemoryUsageEntry
+{
+    MemoryUsageEntry(const QString &name, qint64 count, qint64 bytes, bool limit=false):
+        name(name), count(count), bytes(bytes), limit(limit) {}
+
+    QString name;
+    qint64 count;
+    qint64 bytes;
+    bool limit;
+};
+typedef QList<MemoryUsageEntry> MemoryUsage;
+
+/** Estimates of the memory used by GUI caches and core structures.
+ */
+namespace MemoryAccounting
+{
+    /** Per-element overhead of a node based container (std::map, std::set), for estimates */
+    static const int MAP_NODE_OVERHEAD = 4 * sizeof(void*);
+
+    /** Add the usage of the shared Qt caches */
+    void addQtCaches(MemoryUsage &usage);
+
+    /** Add the transactions of a wallet. Locks the wallet, can be called from any thread. */
+    void addWallet(MemoryUsage &usage, Wallet *wallet, const QString &walletName);
+
+    /** Add the block index, estimated from the best chain height. Can be called from any thread. */
+    void addBlockIndex(MemoryUsage &usage, int bestHeight);
+
+    /** Sum of the entries that are not limits */
+    qint64 total(const MemoryUsage &usage);
+
+    /** Collect the usage of the core structures and GUI caches reachable from the models,
+        either of which can be 0. Call from the GUI thread.
+     */
+    MemoryUsage collect(const ClientModel *clientModel, WalletManager *walletManager);
+
+    /** Human readable table, for the debug log */
+    QString format(const MemoryUsage &usage);
+}
+
+/** Emits requested() from the event loop when the process receives SIGUSR1, so that
+    a running instance can be asked to dump its memory usage. Does nothing on Windows.
+ */
+class MemoryUsageSignal : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MemoryUsageSignal(QObject *parent = 0);
+    ~MemoryUsageSignal();
+
+signals:
+    void requested();
+
+private:
+    QSocketNotifier *notifier;
+
+private slots:
+    void handleSignal();
+};
+
+#endif // MEMORYUSAGE_H
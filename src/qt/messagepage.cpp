@@ -2,6 +2,7 @@
 #include <vector>
 
 #include <QClipboard>
+#include <QFileDialog>
 #include <QInputDialog>
 #include <QList>
 #include <QListWidgetItem>
@@ -16,6 +17,7 @@
 #include "addressbookpage.h"
 #include "guiutil.h"
 #include "walletmodel.h"
+#include "messagesigner.h"
 
 MessagePage::MessagePage(QWidget *parent) :
     QDialog(parent),
@@ -81,25 +83,111 @@ void MessagePage::on_signMessage_clicked()
         return;
     }
 
-    CKey key;
-    if (!model->getWallet()->getKey(addr.getPubKeyHash(), key))
+    QList<MessageSigner::Item> items;
+    items.append(MessageSigner::Item(address, ui->message->document()->toPlainText()));
+    MessageSigner::signBatch(model->getWallet(), items);
+    const MessageSigner::Item &item = items.at(0);
+    if (item.result == MessageSigner::KeyNotAvailable)
     {
         QMessageBox::critical(this, tr("Error signing"), tr("Private key for %1 is not available.").arg(address),
                               QMessageBox::Abort, QMessageBox::Abort);
         return;
     }
-
-    CDataStream ss(SER_GETHASH);
-    ss << model->getWallet()->chain().signedMessageMagic();
-    ss << ui->message->document()->toPlainText().toStdString();
-
-    std::vector<unsigned char> vchSig;
-    if (!key.SignCompact(Hash(ss.begin(), ss.end()), vchSig))
+    if (item.result != MessageSigner::OK)
     {
         QMessageBox::critical(this, tr("Error signing"), tr("Sign failed"),
                               QMessageBox::Abort, QMessageBox::Abort);
+        return;
     }
 
-    ui->signature->setText(QString::fromStdString(Auth::encode64(std::string((char*)&vchSig[0], vchSig.size()))));
+    ui->signature->setText(item.signature);
     ui->signature->setFont(GUIUtil::bitcoinAddressFont());
 }
+
+/* Ask where to save the results of a batch, and write them */
+static void saveBatch(QWidget *parent, const QList<MessageSigner::Item> &items)
+{
+    QString filename = QFileDialog::getSaveFileName(
+            parent,
+            QObject::tr("Save Results"),
+            QDir::currentPath(),
+            QObject::tr("Comma separated file (*.csv)"));
+    if (filename.isNull()) return;
+
+    if(!MessageSigner::writeFile(filename, items))
+    {
+        QMessageBox::critical(parent, QObject::tr("Error saving"), QObject::tr("Could not write to file %1.").arg(filename),
+                              QMessageBox::Abort, QMessageBox::Abort);
+    }
+}
+
+/* Ask for a file of messages, and read it */
+static bool openBatch(QWidget *parent, QList<MessageSigner::Item> &items)
+{
+    QString filename = QFileDialog::getOpenFileName(
+            parent,
+            QObject::tr("Open Messages"),
+            QDir::currentPath(),
+            QObject::tr("Comma separated file (*.csv);;All files (*)"));
+    if (filename.isNull()) return false;
+
+    QString error;
+    if(!MessageSigner::readFile(filename, items, error))
+    {
+        QMessageBox::critical(parent, QObject::tr("Error opening"), QObject::tr("Could not read file %1: %2").arg(filename, error),
+                              QMessageBox::Abort, QMessageBox::Abort);
+        return false;
+    }
+    return true;
+}
+
+void MessagePage::on_signFile_clicked()
+{
+    QList<MessageSigner::Item> items;
+    if(!openBatch(this, items))
+        return;
+
+    WalletModel::UnlockContext ctx(model->requestUnlock());
+    if(!ctx.isValid())
+    {
+        // Unlock wallet was cancelled
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    MessageSigner::signBatch(model->getWallet(), items);
+    QApplication::restoreOverrideCursor();
+
+    int failed = 0;
+    foreach(const MessageSigner::Item &item, items)
+    {
+        if(item.result != MessageSigner::OK)
+            ++failed;
+    }
+    QMessageBox::information(this, tr("Signing finished"),
+            tr("Signed %n message(s).", "", items.size() - failed) + "<br>" +
+            tr("Could not sign %n message(s).", "", failed));
+    saveBatch(this, items);
+}
+
+void MessagePage::on_verifyFile_clicked()
+{
+    QList<MessageSigner::Item> items;
+    if(!openBatch(this, items))
+        return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    MessageSigner::verifyBatch(model->getWallet()->chain(), items);
+    QApplication::restoreOverrideCursor();
+
+    int invalid = 0;
+    foreach(const MessageSigner::Item &item, items)
+    {
+        if(item.result != MessageSigner::OK)
+            ++invalid;
+    }
+    QMessageBox::information(this, tr("Verification finished"),
+            tr("%n valid signature(s).", "", items.size() - invalid) + "<br>" +
+            tr("%n invalid signature(s).", "", invalid));
+    saveBatch(this, items);
+}
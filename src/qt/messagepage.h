@@ -33,6 +33,10 @@ private slots:
 
     void on_signMessage_clicked();
     void on_copyToClipboard_clicked();
+    /** Sign the messages in a file, and save them with their signatures */
+    void on_signFile_clicked();
+    /** Verify the signatures in a file, and save the result of each */
+    void on_verifyFile_clicked();
 };
 
 #endif // MESSAGEPAGE_H
@@ -0,0 +1,81 @@
+#include "messagerpc.h"
+#include "messagesigner.h"
+
+#include <coinWallet/Wallet.h>
+#include <coinHTTP/RPC.h>
+
+#include <boost/foreach.hpp>
+
+using namespace json_spirit;
+
+/* Items from an array of [address, message(, signature)] arrays */
+static QList<MessageSigner::Item> readItems(const Array &rows, size_t fields)
+{
+    QList<MessageSigner::Item> items;
+    items.reserve(rows.size());
+    BOOST_FOREACH(const Value &row, rows)
+    {
+        if(row.type() != array_type || row.get_array().size() != fields)
+            throw RPC::error(RPC::invalid_params, "Expected an array of [address, message" +
+                             std::string(fields > 2 ? ", signature" : "") + "] arrays");
+        const Array &fieldValues = row.get_array();
+        BOOST_FOREACH(const Value &field, fieldValues)
+        {
+            if(field.type() != str_type)
+                throw RPC::error(RPC::invalid_params, "Addresses, messages and signatures must be strings");
+        }
+        items.append(MessageSigner::Item(QString::fromStdString(fieldValues[0].get_str()),
+                                         QString::fromStdString(fieldValues[1].get_str()),
+                                         fields > 2 ? QString::fromStdString(fieldValues[2].get_str()) : QString()));
+    }
+    return items;
+}
+
+static Object writeItem(const MessageSigner::Item &item, bool verify)
+{
+    Object entry;
+    entry.push_back(Pair("address", item.address.toStdString()));
+    if(verify)
+        entry.push_back(Pair("valid", item.result == MessageSigner::OK));
+    else if(item.result == MessageSigner::OK)
+        entry.push_back(Pair("signature", item.signature.toStdString()));
+    if(item.result != MessageSigner::OK)
+        entry.push_back(Pair("error", MessageSigner::resultString(item.result).toStdString()));
+    return entry;
+}
+
+Value SignMessages::operator()(const Array &params, bool fHelp)
+{
+    if(fHelp || params.size() != 1 || params[0].type() != array_type)
+        throw RPC::error(RPC::invalid_params, "signmessages [[address, message], ...]\n"
+                         "Sign each message with the private key of its address.\n"
+                         "Returns an array of {address, signature} or {address, error} objects, in order.");
+    if(_wallet.IsLocked())
+        throw RPC::error(RPC::invalid_params, "Error: Please enter the wallet passphrase with walletpassphrase first.");
+
+    QList<MessageSigner::Item> items = readItems(params[0].get_array(), 2);
+    MessageSigner::signBatch(&_wallet, items);
+
+    Array result;
+    result.reserve(items.size());
+    foreach(const MessageSigner::Item &item, items)
+        result.push_back(writeItem(item, false));
+    return result;
+}
+
+Value VerifyMessages::operator()(const Array &params, bool fHelp)
+{
+    if(fHelp || params.size() != 1 || params[0].type() != array_type)
+        throw RPC::error(RPC::invalid_params, "verifymessages [[address, message, signature], ...]\n"
+                         "Verify each signature against its address and message.\n"
+                         "Returns an array of {address, valid} objects, with an error for invalid signatures, in order.");
+
+    QList<MessageSigner::Item> items = readItems(params[0].get_array(), 3);
+    MessageSigner::verifyBatch(_wallet.chain(), items);
+
+    Array result;
+    result.reserve(items.size());
+    foreach(const MessageSigner::Item &item, items)
+        result.push_back(writeItem(item, true));
+    return result;
+}
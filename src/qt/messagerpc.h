@@ -0,0 +1,34 @@
+#ifndef MESSAGERPC_H
+#define MESSAGERPC_H
+
+#include <coinHTTP/Server.h>
+
+class Wallet;
+
+/** signmessages [[address, message], ...]
+    Sign many messages at once with the keys of the wallet, see MessageSigner::signBatch.
+ */
+class SignMessages : public Method
+{
+public:
+    SignMessages(Wallet &wallet) : _wallet(wallet) {}
+    json_spirit::Value operator()(const json_spirit::Array &params, bool fHelp);
+
+private:
+    Wallet &_wallet;
+};
+
+/** verifymessages [[address, message, signature], ...]
+    Verify many message signatures at once, see MessageSigner::verifyBatch.
+ */
+class VerifyMessages : public Method
+{
+public:
+    VerifyMessages(Wallet &wallet) : _wallet(wallet) {}
+    json_spirit::Value operator()(const json_spirit::Array &params, bool fHelp);
+
+private:
+    Wallet &_wallet;
+};
+
+#endif // MESSAGERPC_H
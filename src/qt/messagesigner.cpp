@@ -0,0 +1,241 @@
+#include "messagesigner.h"
+#include "guiutil.h"
+
+#include <QtConcurrentMap>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QVector>
+
+#include <coinWallet/Wallet.h>
+
+#include <map>
+
+/* Items handed to a worker at a time. A signature takes a fraction of a millisecond, so chunks keep
+   the scheduling overhead low while still spreading small batches over the cores.
+ */
+static const int BATCH_CHUNK_SIZE = 32;
+
+static uint256 messageHash(const Chain &chain, const QString &message)
+{
+    CDataStream ss(SER_GETHASH);
+    ss << chain.signedMessageMagic();
+    ss << message.toStdString();
+    return Hash(ss.begin(), ss.end());
+}
+
+struct SignChunk
+{
+    MessageSigner::Item *items;
+    int begin;
+    int end;
+    const Chain *chain;
+    const std::map<QString, CKey> *keys;
+};
+
+static void signChunk(SignChunk &chunk)
+{
+    for(int idx = chunk.begin; idx < chunk.end; ++idx)
+    {
+        MessageSigner::Item &item = chunk.items[idx];
+        if(item.result != MessageSigner::OK)
+            continue;
+        // Every worker signs with its own copy, a key is not safe to use from several threads
+        CKey key = chunk.keys->find(item.address)->second;
+        if(!MessageSigner::sign(*chunk.chain, key, item.message, item.signature))
+            item.result = MessageSigner::SigningFailed;
+    }
+}
+
+struct VerifyChunk
+{
+    MessageSigner::Item *items;
+    int begin;
+    int end;
+    const Chain *chain;
+};
+
+static void verifyChunk(VerifyChunk &chunk)
+{
+    for(int idx = chunk.begin; idx < chunk.end; ++idx)
+    {
+        MessageSigner::Item &item = chunk.items[idx];
+        item.result = MessageSigner::verify(*chunk.chain, item.address, item.message, item.signature);
+    }
+}
+
+bool MessageSigner::sign(const Chain &chain, CKey &key, const QString &message, QString &signature)
+{
+    std::vector<unsigned char> vchSig;
+    if(!key.SignCompact(messageHash(chain, message), vchSig))
+        return false;
+    signature = QString::fromLatin1(QByteArray((const char*)&vchSig[0], vchSig.size()).toBase64());
+    return true;
+}
+
+MessageSigner::Result MessageSigner::verify(const Chain &chain, const QString &address, const QString &message, const QString &signature)
+{
+    if(!chain.getAddress(address.toStdString()).isValid())
+        return InvalidAddress;
+    QByteArray sig = QByteArray::fromBase64(signature.toLatin1());
+    std::vector<unsigned char> vchSig(sig.begin(), sig.end());
+    CKey key;
+    if(vchSig.size() != 65 || !key.SetCompactSignature(messageHash(chain, message), vchSig))
+        return MalformedSignature;
+    QString signer = QString::fromStdString(chain.getAddress(toPubKeyHash(key.GetPubKey())).toString());
+    return signer == address ? OK : AddressMismatch;
+}
+
+template<typename Chunk>
+static QList<Chunk> makeChunks(MessageSigner::Item *items, int size, const Chunk &prototype)
+{
+    QList<Chunk> chunks;
+    for(int begin = 0; begin < size; begin += BATCH_CHUNK_SIZE)
+    {
+        Chunk chunk = prototype;
+        chunk.items = items;
+        chunk.begin = begin;
+        chunk.end = qMin(begin + BATCH_CHUNK_SIZE, size);
+        chunks.append(chunk);
+    }
+    return chunks;
+}
+
+void MessageSigner::signBatch(Wallet *wallet, QList<Item> &items)
+{
+    // The workers write into a vector, so that no list is detached by several threads at once
+    QVector<Item> work = items.toVector();
+    const Chain &chain = wallet->chain();
+
+    // Fetch the keys up front, once per address and under a single wallet lock
+    std::map<QString, CKey> keys;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        for(int idx = 0; idx < work.size(); ++idx)
+        {
+            Item &item = work[idx];
+            item.result = OK;
+            if(keys.count(item.address))
+                continue;
+            ChainAddress address = chain.getAddress(item.address.toStdString());
+            if(!address.isValid())
+            {
+                item.result = InvalidAddress;
+                continue;
+            }
+            CKey key;
+            if(wallet->IsLocked() || !wallet->getKey(address.getPubKeyHash(), key))
+            {
+                item.result = KeyNotAvailable;
+                continue;
+            }
+            keys[item.address] = key;
+        }
+    }
+
+    SignChunk prototype;
+    prototype.chain = &chain;
+    prototype.keys = &keys;
+    QList<SignChunk> chunks = makeChunks(work.data(), work.size(), prototype);
+    if(chunks.size() == 1)
+        signChunk(chunks[0]);
+    else
+        QtConcurrent::blockingMap(chunks, signChunk);
+    items = work.toList();
+}
+
+void MessageSigner::verifyBatch(const Chain &chain, QList<Item> &items)
+{
+    QVector<Item> work = items.toVector();
+
+    VerifyChunk prototype;
+    prototype.chain = &chain;
+    QList<VerifyChunk> chunks = makeChunks(work.data(), work.size(), prototype);
+    if(chunks.size() == 1)
+        verifyChunk(chunks[0]);
+    else
+        QtConcurrent::blockingMap(chunks, verifyChunk);
+    items = work.toList();
+}
+
+bool MessageSigner::readFile(const QString &filename, QList<Item> &items, QString &error)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = file.errorString();
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+
+    QList<QStringList> records;
+    QList<int> lines;
+    if(!GUIUtil::parseCSV(in.readAll(), records, &lines))
+    {
+        error = QObject::tr("Unterminated quoted field on line %1").arg(lines.last());
+        return false;
+    }
+    int first = 0;
+    if(!records.isEmpty() && records.at(0).at(0).compare("address", Qt::CaseInsensitive) == 0)
+        first = 1;
+    items.reserve(items.size() + records.size() - first);
+    for(int i = first; i < records.size(); ++i)
+    {
+        const QStringList &record = records.at(i);
+        if(record.size() < 2)
+        {
+            error = QObject::tr("Missing message on line %1").arg(lines.at(i));
+            return false;
+        }
+        items.append(Item(record.at(0), record.at(1), record.size() > 2 ? record.at(2) : QString()));
+    }
+    return true;
+}
+
+static QString quoteCSV(const QString &value)
+{
+    QString quoted = value;
+    quoted.replace('"', "\"\"");
+    return "\"" + quoted + "\"";
+}
+
+bool MessageSigner::writeFile(const QString &filename, const QList<Item> &items)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+
+    out << "\"Address\",\"Message\",\"Signature\",\"Result\"\n";
+    foreach(const Item &item, items)
+    {
+        out << quoteCSV(item.address) << "," << quoteCSV(item.message) << ","
+            << quoteCSV(item.signature) << "," << quoteCSV(resultString(item.result)) << "\n";
+    }
+    out.flush();
+    file.close();
+
+    return file.error() == QFile::NoError;
+}
+
+QString MessageSigner::resultString(Result result)
+{
+    switch(result)
+    {
+    case OK:
+        return QObject::tr("OK");
+    case InvalidAddress:
+        return QObject::tr("Invalid address");
+    case KeyNotAvailable:
+        return QObject::tr("Private key not available");
+    case SigningFailed:
+        return QObject::tr("Sign failed");
+    case MalformedSignature:
+        return QObject::tr("Malformed signature");
+    case AddressMismatch:
+        return QObject::tr("Signed by another address");
+    }
+    return QString();
+}
@@ -0,0 +1,65 @@
+#ifndef MESSAGESIGNER_H
+#define MESSAGESIGNER_H
+
+#include <QString>
+#include <QList>
+
+class Wallet;
+class Chain;
+class CKey;
+
+/** Signs messages with wallet keys and verifies message signatures, in batches spread over the
+    available cores. Signatures are compact signatures over the hash of the chain's signed message
+    magic and the message, base64 encoded, as made by the Sign Message page. Verification recovers
+    the public key from the signature and compares its address, so it needs no wallet keys.
+ */
+class MessageSigner
+{
+public:
+    enum Result
+    {
+        OK,
+        InvalidAddress,
+        KeyNotAvailable,    /**< Signing: the wallet has no private key for the address */
+        SigningFailed,
+        MalformedSignature, /**< Verifying: not a base64 encoded compact signature */
+        AddressMismatch     /**< Verifying: the signature is valid, but made by another key */
+    };
+
+    struct Item
+    {
+        Item(): result(OK) {}
+        Item(const QString &address, const QString &message, const QString &signature = QString()):
+            address(address), message(message), signature(signature), result(OK) {}
+        QString address;
+        QString message;
+        QString signature;
+        Result result;
+    };
+
+    /** Sign the message of every item with the key of its address, and fill in the signature.
+        The wallet must be unlocked.
+     */
+    static void signBatch(Wallet *wallet, QList<Item> &items);
+    /** Check the signature of every item against its address and message */
+    static void verifyBatch(const Chain &chain, QList<Item> &items);
+
+    /** Sign a single message, returns false if signing failed. Not thread safe for a given key. */
+    static bool sign(const Chain &chain, CKey &key, const QString &message, QString &signature);
+    /** Check a single signature against an address and message */
+    static Result verify(const Chain &chain, const QString &address, const QString &message, const QString &signature);
+
+    /** Read items from CSV rows of address, message and optionally signature. A header row naming
+        an "address" column is skipped. Returns false and sets error if the file could not be read.
+     */
+    static bool readFile(const QString &filename, QList<Item> &items, QString &error);
+    /** Write items as CSV rows of address, message, signature and result */
+    static bool writeFile(const QString &filename, const QList<Item> &items);
+
+    static QString resultString(Result result);
+
+private:
+    MessageSigner() {}
+};
+
+#endif // MESSAGESIGNER_H
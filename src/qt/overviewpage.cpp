@@ -11,6 +11,7 @@
 
 #include <QAbstractItemDelegate>
 #include <QPainter>
+#include <QTimer>
 
 #define DECORATION_SIZE 64
 #define NUM_ITEMS 3
@@ -66,12 +67,14 @@ public:
             foreground = option.palette.color(QPalette::Text);
         }
         painter->setPen(foreground);
-        QString amountText = BitcoinUnits::formatWithUnit(unit, amount, true);
+        QChar amountText[BitcoinUnits::MAX_FORMAT_WITH_UNIT_LENGTH + 2];
+        int len = 0;
         if(!confirmed)
-        {
-            amountText = QString("[") + amountText + QString("]");
-        }
-        painter->drawText(amountRect, Qt::AlignRight|Qt::AlignVCenter, amountText);
+            amountText[len++] = '[';
+        len += BitcoinUnits::formatWithUnit(unit, amount, true, amountText + len);
+        if(!confirmed)
+            amountText[len++] = ']';
+        painter->drawText(amountRect, Qt::AlignRight|Qt::AlignVCenter, QString::fromRawData(amountText, len));
 
         painter->setPen(option.palette.color(QPalette::Text));
         painter->drawText(amountRect, Qt::AlignLeft|Qt::AlignVCenter, GUIUtil::dateTimeStr(date));
@@ -92,6 +95,7 @@ public:
 OverviewPage::OverviewPage(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::OverviewPage),
+    model(0),
     currentBalance(-1),
     currentUnconfirmedBalance(-1),
     txdelegate(new TxViewDelegate())
@@ -142,12 +146,40 @@ void OverviewPage::setNumTransactions(int count)
 
 void OverviewPage::setModel(WalletModel *model)
 {
+    if(this->model)
+    {
+        // Switching wallets, drop everything that refers to the previous one
+        disconnect(this->model, 0, this, 0);
+        disconnect(this->model->getOptionsModel(), 0, this, 0);
+    }
     this->model = model;
+    // The transaction table of a large wallet is expensive to create, leave it until the
+    // page is shown and the balances have been painted
+    setTransactionModel(0);
+    if(model && isVisible())
+        QTimer::singleShot(0, this, SLOT(showRecentTransactions()));
     if(model)
+    {
+        // Keep up to date with wallet
+        setBalance(model->getBalance(), model->getUnconfirmedBalance());
+        connect(model, SIGNAL(balanceChanged(qint64, qint64)), this, SLOT(setBalance(qint64, qint64)));
+
+        setNumTransactions(model->getNumTransactions());
+        connect(model, SIGNAL(numTransactionsChanged(int)), this, SLOT(setNumTransactions(int)));
+
+        connect(model->getOptionsModel(), SIGNAL(displayUnitChanged(int)), this, SLOT(displayUnitChanged()));
+    }
+}
+
+void OverviewPage::setTransactionModel(QAbstractItemModel *transactionModel)
+{
+    // Drop the filter of the previous wallet
+    delete qobject_cast<TransactionFilterProxy*>(ui->listTransactions->model());
+    if(transactionModel)
     {
         // Set up transaction list
-        TransactionFilterProxy *filter = new TransactionFilterProxy();
-        filter->setSourceModel(model->getTransactionTableModel());
+        TransactionFilterProxy *filter = new TransactionFilterProxy(this);
+        filter->setSourceModel(transactionModel);
         filter->setLimit(NUM_ITEMS);
         filter->setDynamicSortFilter(true);
         filter->setSortRole(Qt::EditRole);
@@ -155,16 +187,21 @@ void OverviewPage::setModel(WalletModel *model)
 
         ui->listTransactions->setModel(filter);
         ui->listTransactions->setModelColumn(TransactionTableModel::ToAddress);
+    }
+}
 
-        // Keep up to date with wallet
-        setBalance(model->getBalance(), model->getUnconfirmedBalance());
-        connect(model, SIGNAL(balanceChanged(qint64, qint64)), this, SLOT(setBalance(qint64, qint64)));
-
-        setNumTransactions(model->getNumTransactions());
-        connect(model, SIGNAL(numTransactionsChanged(int)), this, SLOT(setNumTransactions(int)));
+void OverviewPage::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if(model && !qobject_cast<TransactionFilterProxy*>(ui->listTransactions->model()))
+        QTimer::singleShot(0, this, SLOT(showRecentTransactions()));
+}
 
-        connect(model->getOptionsModel(), SIGNAL(displayUnitChanged(int)), this, SLOT(displayUnitChanged()));
-    }
+void OverviewPage::showRecentTransactions()
+{
+    // Can be queued more than once, or for a wallet that was switched away from since
+    if(model && !qobject_cast<TransactionFilterProxy*>(ui->listTransactions->model()))
+        setTransactionModel(model->getTransactionTableModel());
 }
 
 void OverviewPage::displayUnitChanged()
@@ -5,6 +5,8 @@
 
 QT_BEGIN_NAMESPACE
 class QModelIndex;
+class QAbstractItemModel;
+class QShowEvent;
 QT_END_NAMESPACE
 
 namespace Ui {
@@ -23,6 +25,11 @@ public:
     ~OverviewPage();
 
     void setModel(WalletModel *model);
+    /** Show the recent transactions of a model with the columns and roles of TransactionTableModel.
+        The page does this for the wallet's table model once it is shown, the UI benchmarks use it
+        without a wallet model.
+     */
+    void setTransactionModel(QAbstractItemModel *transactionModel);
 
 public slots:
     void setBalance(qint64 balance, qint64 unconfirmedBalance);
@@ -31,6 +38,9 @@ public slots:
 signals:
     void transactionClicked(const QModelIndex &index);
 
+protected:
+    void showEvent(QShowEvent *event);
+
 private:
     Ui::OverviewPage *ui;
     WalletModel *model;
@@ -41,6 +51,8 @@ private:
 
 private slots:
     void displayUnitChanged();
+    /** Show the recent transactions of the wallet model, creating its transaction table if needed */
+    void showRecentTransactions();
 };
 
 #endif // OVERVIEWPAGE_H
@@ -0,0 +1,84 @@
+#include "peersdialog.h"
+#include "ui_peersdialog.h"
+#include "clientmodel.h"
+#include "peertablemodel.h"
+
+#include <QSortFilterProxyModel>
+#include <QHeaderView>
+
+PeersDialog::PeersDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::PeersDialog),
+    model(0),
+    proxyModel(0)
+{
+    ui->setupUi(this);
+
+    if(!PeerTableModel::isAvailable())
+    {
+        ui->tableView->hide();
+        ui->disconnectButton->hide();
+    }
+}
+
+PeersDialog::~PeersDialog()
+{
+    delete ui;
+}
+
+void PeersDialog::setModel(ClientModel *model)
+{
+    this->model = model;
+    if(!model)
+        return;
+
+    setNumConnections(model->getNumConnections());
+    connect(model, SIGNAL(numConnectionsChanged(int)), this, SLOT(setNumConnections(int)));
+
+    proxyModel = new QSortFilterProxyModel(this);
+    proxyModel->setSourceModel(model->getPeerTableModel());
+    proxyModel->setSortRole(Qt::EditRole);
+    ui->tableView->setModel(proxyModel);
+    ui->tableView->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+    ui->tableView->sortByColumn(PeerTableModel::Ping, Qt::DescendingOrder);
+
+    connect(ui->tableView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(selectionChanged()));
+    if(isVisible())
+        model->getPeerTableModel()->startAutoRefresh();
+}
+
+void PeersDialog::showEvent(QShowEvent *event)
+{
+    if(model)
+        model->getPeerTableModel()->startAutoRefresh();
+    QDialog::showEvent(event);
+}
+
+void PeersDialog::hideEvent(QHideEvent *event)
+{
+    if(model)
+        model->getPeerTableModel()->stopAutoRefresh();
+    QDialog::hideEvent(event);
+}
+
+void PeersDialog::setNumConnections(int count)
+{
+    QString text = tr("Connected to %n peer(s).", "", count);
+    if(!PeerTableModel::isAvailable())
+        text += " " + tr("Statistics of the individual peers are not available in this version.");
+    ui->connectionsLabel->setText(text);
+}
+
+void PeersDialog::selectionChanged()
+{
+    ui->disconnectButton->setEnabled(ui->tableView->selectionModel()->hasSelection());
+}
+
+void PeersDialog::on_disconnectButton_clicked()
+{
+    QModelIndexList selection = ui->tableView->selectionModel()->selectedRows(PeerTableModel::Address);
+    if(!model || selection.isEmpty())
+        return;
+    model->getPeerTableModel()->disconnectPeer(selection.at(0).data(Qt::EditRole).toString());
+}
@@ -0,0 +1,44 @@
+#ifndef PEERSDIALOG_H
+#define PEERSDIALOG_H
+
+#include <QDialog>
+
+namespace Ui {
+    class PeersDialog;
+}
+class ClientModel;
+
+QT_BEGIN_NAMESPACE
+class QSortFilterProxyModel;
+QT_END_NAMESPACE
+
+/** Shows the number of connections and the statistics of the connected peers, and allows
+    disconnecting them. The peer table is only refreshed while the dialog is shown, and only
+    present in builds that can read it (PeerTableModel::isAvailable()).
+ */
+class PeersDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PeersDialog(QWidget *parent = 0);
+    ~PeersDialog();
+
+    void setModel(ClientModel *model);
+
+protected:
+    void showEvent(QShowEvent *event);
+    void hideEvent(QHideEvent *event);
+
+private:
+    Ui::PeersDialog *ui;
+    ClientModel *model;
+    QSortFilterProxyModel *proxyModel;
+
+private slots:
+    void setNumConnections(int count);
+    void selectionChanged();
+    void on_disconnectButton_clicked();
+};
+
+#endif // PEERSDIALOG_H
@@ -0,0 +1,204 @@
+#include "peertablemodel.h"
+#include "guiconstants.h"
+
+#include <coinChain/Node.h>
+
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+
+#include <boost/foreach.hpp>
+
+// Read the statistics of all connected peers from the node. Without USE_PEER_STATS libcoin offers
+// no per-peer information, and the table stays empty.
+static QList<PeerStats> queryPeers(const Node &node)
+{
+    QList<PeerStats> peers;
+#ifdef USE_PEER_STATS
+    BOOST_FOREACH(const PeerInfo &info, node.getPeerInfo())
+    {
+        PeerStats stats;
+        stats.address = QString::fromStdString(info.endpoint);
+        stats.version = info.version;
+        stats.startingHeight = info.startingHeight;
+        stats.pingMSecs = info.pingTime;
+        stats.bytesSent = info.bytesSent;
+        stats.bytesReceived = info.bytesReceived;
+        stats.messagesSent = info.messagesSent;
+        stats.messagesReceived = info.messagesReceived;
+        stats.blocksServed = info.blocksServed;
+        peers.append(stats);
+    }
+#else
+    Q_UNUSED(node);
+#endif
+    return peers;
+}
+
+// Private implementation
+struct PeerTablePriv
+{
+    QList<PeerStats> cachedPeers;
+    // Row of each peer in cachedPeers, by address
+    QHash<QString, int> rowByAddress;
+
+    void reindex()
+    {
+        rowByAddress.clear();
+        for(int row = 0; row < cachedPeers.size(); ++row)
+            rowByAddress.insert(cachedPeers.at(row).address, row);
+    }
+};
+
+static bool operator!=(const PeerStats &a, const PeerStats &b)
+{
+    return a.version != b.version || a.startingHeight != b.startingHeight || a.pingMSecs != b.pingMSecs ||
+           a.bytesSent != b.bytesSent || a.bytesReceived != b.bytesReceived ||
+           a.messagesSent != b.messagesSent || a.messagesReceived != b.messagesReceived ||
+           a.blocksServed != b.blocksServed;
+}
+
+PeerTableModel::PeerTableModel(Node &node, QObject *parent) :
+    QAbstractTableModel(parent), node(node), priv(new PeerTablePriv()), timer(new QTimer(this))
+{
+    columns << tr("Address") << tr("Version") << tr("Start height") << tr("Ping (ms)")
+            << tr("Bytes sent") << tr("Bytes received") << tr("Messages sent") << tr("Messages received")
+            << tr("Blocks served");
+    connect(timer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+PeerTableModel::~PeerTableModel()
+{
+    delete priv;
+}
+
+void PeerTableModel::startAutoRefresh()
+{
+    refresh();
+    timer->start(PEER_UPDATE_DELAY);
+}
+
+void PeerTableModel::stopAutoRefresh()
+{
+    timer->stop();
+}
+
+void PeerTableModel::refresh()
+{
+    QList<PeerStats> peers = queryPeers(node);
+
+    QSet<QString> connected;
+    foreach(const PeerStats &stats, peers)
+        connected.insert(stats.address);
+
+    // Remove disconnected peers, from the end so that earlier rows keep their index
+    for(int row = priv->cachedPeers.size() - 1; row >= 0; --row)
+    {
+        if(!connected.contains(priv->cachedPeers.at(row).address))
+        {
+            beginRemoveRows(QModelIndex(), row, row);
+            priv->cachedPeers.removeAt(row);
+            endRemoveRows();
+        }
+    }
+    priv->reindex();
+
+    // Update the peers that changed, and append new ones
+    foreach(const PeerStats &stats, peers)
+    {
+        QHash<QString, int>::const_iterator it = priv->rowByAddress.find(stats.address);
+        if(it != priv->rowByAddress.end())
+        {
+            int row = it.value();
+            if(priv->cachedPeers.at(row) != stats)
+            {
+                priv->cachedPeers[row] = stats;
+                emit dataChanged(index(row, Version), index(row, BlocksServed));
+            }
+        }
+        else
+        {
+            int row = priv->cachedPeers.size();
+            beginInsertRows(QModelIndex(), row, row);
+            priv->cachedPeers.append(stats);
+            priv->rowByAddress.insert(stats.address, row);
+            endInsertRows();
+        }
+    }
+}
+
+bool PeerTableModel::isAvailable()
+{
+#ifdef USE_PEER_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PeerTableModel::disconnectPeer(const QString &address)
+{
+#ifdef USE_PEER_STATS
+    node.disconnectPeer(address.toStdString());
+    refresh();
+#else
+    Q_UNUSED(address);
+#endif
+}
+
+int PeerTableModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return priv->cachedPeers.size();
+}
+
+int PeerTableModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return columns.size();
+}
+
+QVariant PeerTableModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= priv->cachedPeers.size())
+        return QVariant();
+    const PeerStats &stats = priv->cachedPeers.at(index.row());
+
+    if(role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+        switch(index.column())
+        {
+        case Address:
+            return stats.address;
+        case Version:
+            return stats.version;
+        case StartingHeight:
+            return stats.startingHeight;
+        case Ping:
+            return stats.pingMSecs;
+        case BytesSent:
+            return stats.bytesSent;
+        case BytesReceived:
+            return stats.bytesReceived;
+        case MessagesSent:
+            return stats.messagesSent;
+        case MessagesReceived:
+            return stats.messagesReceived;
+        case BlocksServed:
+            return stats.blocksServed;
+        }
+    }
+    else if(role == Qt::TextAlignmentRole)
+    {
+        if(index.column() != Address)
+            return (int)(Qt::AlignRight|Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant PeerTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole && section < columns.size())
+        return columns[section];
+    return QVariant();
+}
@@ -0,0 +1,79 @@
+#ifndef PEERTABLEMODEL_H
+#define PEERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QList>
+
+class Node;
+class PeerTablePriv;
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+/** Statistics of one connected peer, as last read from the node.
+ */
+struct PeerStats
+{
+    QString address;
+    int version;
+    int startingHeight;
+    int pingMSecs;
+    qint64 bytesSent;
+    qint64 bytesReceived;
+    qint64 messagesSent;
+    qint64 messagesReceived;
+    int blocksServed;
+};
+
+/** UI model for the peers the node is connected to. Only refreshed while auto refresh is
+    on, which views turn on when shown, and updated incrementally by peer address.
+
+    Reading and disconnecting peers needs libcoin support, and is only built with USE_PEER_STATS.
+    Otherwise the table is always empty, see isAvailable().
+ */
+class PeerTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit PeerTableModel(Node &node, QObject *parent = 0);
+    ~PeerTableModel();
+
+    enum ColumnIndex {
+        Address = 0,
+        Version = 1,
+        StartingHeight = 2,
+        Ping = 3,
+        BytesSent = 4,
+        BytesReceived = 5,
+        MessagesSent = 6,
+        MessagesReceived = 7,
+        BlocksServed = 8
+    };
+
+    int rowCount(const QModelIndex &parent) const;
+    int columnCount(const QModelIndex &parent) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+    /** Whether this build can read the statistics of the peers */
+    static bool isAvailable();
+
+    /** Close the connection to the peer at address */
+    void disconnectPeer(const QString &address);
+
+public slots:
+    void startAutoRefresh();
+    void stopAutoRefresh();
+    /** Read the peer statistics from the node and update the changed rows */
+    void refresh();
+
+private:
+    Node &node;
+    QStringList columns;
+    PeerTablePriv *priv;
+    QTimer *timer;
+};
+
+#endif // PEERTABLEMODEL_H
@@ -2,76 +2,103 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file license.txt or http://www.opensource.org/licenses/mit-license.php.
 
-#include <boost/algorithm/string.hpp>
-#include <boost/interprocess/ipc/message_queue.hpp>
-#include <boost/tokenizer.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
+#include "qtipcserver.h"
 
-using namespace boost::interprocess;
-using namespace boost::posix_time;
-using namespace boost;
-using namespace std;
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDir>
 
-#include <coin/util.h>
+#include <string.h>
 
-void ipcShutdown()
+/* Milliseconds to wait for a running instance to accept or read our URIs */
+static const int IPC_CONNECT_TIMEOUT = 1000;
+
+// One channel per user, as local server names are global on some platforms
+static QString ipcServerName()
+{
+    return QString("BitcoinURL-") + QDir::home().dirName();
+}
+
+IPCServer::IPCServer(QObject *parent) :
+    QObject(parent), server(new QLocalServer(this))
 {
-//    message_queue::remove("BitcoinURL");
+    connect(server, SIGNAL(newConnection()), this, SLOT(newConnection()));
 }
 
-void ipcThread(void* parg)
-{/*
-    message_queue* mq = (message_queue*)parg;
-    char strBuf[257];
-    size_t nSize;
-    unsigned int nPriority;
-    loop
+bool IPCServer::listen()
+{
+    if(server->listen(ipcServerName()))
+        return true;
+    // A previous instance that crashed can leave its socket behind, but so does one that is
+    // running: only take over the name if nothing accepts a connection on it
+    QLocalSocket probe;
+    probe.connectToServer(ipcServerName());
+    if(probe.waitForConnected(IPC_CONNECT_TIMEOUT))
     {
-        ptime d = boost::posix_time::microsec_clock::universal_time() + millisec(100);
-        if(mq->timed_receive(&strBuf, sizeof(strBuf), nSize, nPriority, d))
-        {
-            ThreadSafeHandleURL(std::string(strBuf, nSize));
-            Sleep(1000);
-        }
-        if (fShutdown)
-        {
-            ipcShutdown();
-            break;
-        }
+        probe.disconnectFromServer();
+        return false;
     }
-    ipcShutdown();
-*/}
-
-void ipcInit()
-{/*
-    message_queue* mq;
-    char strBuf[257];
-    size_t nSize;
-    unsigned int nPriority;
-    try {
-        mq = new message_queue(open_or_create, "BitcoinURL", 2, 256);
+    QLocalServer::removeServer(ipcServerName());
+    return server->listen(ipcServerName());
+}
 
-        // Make sure we don't lose any bitcoin: URIs
-        for (int i = 0; i < 2; i++)
-        {
-            ptime d = boost::posix_time::microsec_clock::universal_time() + millisec(1);
-            if(mq->timed_receive(&strBuf, sizeof(strBuf), nSize, nPriority, d))
-            {
-                ThreadSafeHandleURL(std::string(strBuf, nSize));
-            }
-            else
-                break;
-        }
+bool IPCServer::sendToRunningInstance(const QStringList &urls)
+{
+    QLocalSocket socket;
+    socket.connectToServer(ipcServerName(), QIODevice::WriteOnly);
+    if(!socket.waitForConnected(IPC_CONNECT_TIMEOUT))
+        return false;
+    foreach(const QString &url, urls)
+    {
+        socket.write(url.toUtf8());
+        socket.write("\n");
+    }
+    socket.flush();
+    socket.waitForBytesWritten(IPC_CONNECT_TIMEOUT);
+    socket.disconnectFromServer();
+    return true;
+}
 
-        // Make sure only one bitcoin instance is listening
-        message_queue::remove("BitcoinURL");
-        mq = new message_queue(open_or_create, "BitcoinURL", 2, 256);
+QStringList IPCServer::takeURLsFromArguments(int &argc, char *argv[])
+{
+    QStringList urls;
+    int kept = 1;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strlen(argv[i]) > 7 && strncasecmp(argv[i], "bitcoin:", 8) == 0)
+            urls.append(QString::fromLocal8Bit(argv[i]));
+        else
+            argv[kept++] = argv[i];
     }
-    catch (interprocess_exception &ex) {
-        return;
+    argc = kept;
+    argv[argc] = 0;
+    return urls;
+}
+
+void IPCServer::newConnection()
+{
+    while(QLocalSocket *socket = server->nextPendingConnection())
+    {
+        connect(socket, SIGNAL(readyRead()), this, SLOT(socketReadyRead()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        // Data can arrive before readyRead is connected
+        readURLs(socket);
     }
-    if (!CreateThread(ipcThread, mq))
+}
+
+void IPCServer::socketReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    if(socket)
+        readURLs(socket);
+}
+
+void IPCServer::readURLs(QLocalSocket *socket)
+{
+    while(socket->canReadLine())
     {
-        delete mq;
+        QString url = QString::fromUtf8(socket->readLine()).trimmed();
+        if(!url.isEmpty())
+            emit receivedURL(url);
     }
-*/}
+}
@@ -1,2 +1,49 @@
-void ipcInit();
-void ipcShutdown();
+#ifndef QTIPCSERVER_H
+#define QTIPCSERVER_H
+
+#include <QObject>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QLocalServer;
+class QLocalSocket;
+QT_END_NAMESPACE
+
+/** Local socket server that receives bitcoin: URIs from other instances started by the same user,
+    so that only one instance is running and URIs clicked while it runs are not lost.
+    Connections are handled from the Qt event loop, nothing is polled.
+ */
+class IPCServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit IPCServer(QObject *parent = 0);
+
+    /** Start listening, returns false if the channel could not be set up. */
+    bool listen();
+
+    /** Send URIs to a running instance. Returns false if no instance is running, so
+        this one should start normally.
+    */
+    static bool sendToRunningInstance(const QStringList &urls);
+
+    /** Remove the bitcoin: URIs from the command line arguments and return them, so that the
+        remaining arguments can be parsed as options without URIs being taken for an RPC command.
+    */
+    static QStringList takeURLsFromArguments(int &argc, char *argv[]);
+
+signals:
+    /** A URI was received from another instance */
+    void receivedURL(const QString &url);
+
+private:
+    QLocalServer *server;
+
+    void readURLs(QLocalSocket *socket);
+
+private slots:
+    void newConnection();
+    void socketReadyRead();
+};
+
+#endif // QTIPCSERVER_H
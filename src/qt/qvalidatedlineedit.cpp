@@ -33,6 +33,14 @@ void QValidatedLineEdit::focusInEvent(QFocusEvent *evt)
     QLineEdit::focusInEvent(evt);
 }
 
+void QValidatedLineEdit::focusOutEvent(QFocusEvent *evt)
+{
+    // Flag input that the validator does not accept, such as an address with a wrong checksum
+    if(!text().isEmpty() && !hasAcceptableInput())
+        setValid(false);
+    QLineEdit::focusOutEvent(evt);
+}
+
 void QValidatedLineEdit::markValid()
 {
     setValid(true);
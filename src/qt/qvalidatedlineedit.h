@@ -15,6 +15,7 @@ public:
 
 protected:
     void focusInEvent(QFocusEvent *evt);
+    void focusOutEvent(QFocusEvent *evt);
 
 private:
     bool valid;
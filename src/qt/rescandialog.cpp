@@ -0,0 +1,52 @@
+#include "rescandialog.h"
+#include "ui_rescandialog.h"
+
+RescanDialog::RescanDialog(const QDateTime &birthday, int numBlocks, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::RescanDialog)
+{
+    ui->setupUi(this);
+
+    ui->heightEdit->setMaximum(numBlocks);
+    ui->dateEdit->setMaximumDate(QDate::currentDate());
+    if(birthday.isValid())
+    {
+        ui->birthdayButton->setText(tr("From the wallet &creation date (%1)").arg(birthday.date().toString(Qt::SystemLocaleShortDate)));
+        ui->dateEdit->setDate(birthday.date());
+    }
+    else
+    {
+        // Without a known birthday the whole chain has to be scanned
+        ui->birthdayButton->setText(tr("From the &beginning of the block chain"));
+        ui->dateEdit->setDate(QDate::currentDate());
+    }
+
+    connect(ui->dateButton, SIGNAL(toggled(bool)), ui->dateEdit, SLOT(setEnabled(bool)));
+    connect(ui->heightButton, SIGNAL(toggled(bool)), ui->heightEdit, SLOT(setEnabled(bool)));
+    ui->dateEdit->setEnabled(false);
+    ui->heightEdit->setEnabled(false);
+}
+
+RescanDialog::~RescanDialog()
+{
+    delete ui;
+}
+
+RescanDialog::Mode RescanDialog::getMode() const
+{
+    if(ui->dateButton->isChecked())
+        return FromDate;
+    if(ui->heightButton->isChecked())
+        return FromHeight;
+    return FromBirthday;
+}
+
+QDateTime RescanDialog::getDate() const
+{
+    return QDateTime(ui->dateEdit->date());
+}
+
+int RescanDialog::getHeight() const
+{
+    return ui->heightEdit->value();
+}
@@ -0,0 +1,36 @@
+#ifndef RESCANDIALOG_H
+#define RESCANDIALOG_H
+
+#include <QDialog>
+#include <QDateTime>
+
+namespace Ui {
+    class RescanDialog;
+}
+
+/** Dialog to choose where a wallet rescan starts: the wallet birthday, a date or a block height.
+ */
+class RescanDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        FromBirthday,
+        FromDate,
+        FromHeight
+    };
+
+    /** birthday is the wallet creation time, invalid if unknown. */
+    explicit RescanDialog(const QDateTime &birthday, int numBlocks, QWidget *parent = 0);
+    ~RescanDialog();
+
+    Mode getMode() const;
+    QDateTime getDate() const;
+    int getHeight() const;
+
+private:
+    Ui::RescanDialog *ui;
+};
+
+#endif // RESCANDIALOG_H
@@ -36,6 +36,8 @@ SendCoinsDialog::SendCoinsDialog(QWidget *parent) :
 
 void SendCoinsDialog::setModel(WalletModel *model)
 {
+    if(this->model)
+        disconnect(this->model, 0, this, 0);
     this->model = model;
 
     for(int i = 0; i < ui->entries->count(); ++i)
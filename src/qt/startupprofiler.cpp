@@ -0,0 +1,106 @@
+#include "startupprofiler.h"
+
+#include <coinHTTP/RPC.h>
+
+#include <fstream>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+// CPU time used by the process so far in milliseconds, -1 if unsupported
+static qint64 processCpuMs()
+{
+#ifndef WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return (qint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#else
+    return -1;
+#endif
+}
+
+// Peak resident set size of the process in kilobytes, -1 if unsupported
+static qint64 processPeakRssKb()
+{
+#ifndef WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss / 1024; // bytes on Mac OS X
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+StartupProfiler::StartupProfiler(QObject *parent) :
+    QObject(parent), phaseCpuStart(0)
+{
+    totalTimer.start();
+}
+
+void StartupProfiler::beginPhase(const std::string &name)
+{
+    endPhase();
+    currentPhase = name;
+    phaseTimer.start();
+    phaseCpuStart = processCpuMs();
+}
+
+void StartupProfiler::endPhase()
+{
+    if(currentPhase.empty())
+        return;
+    Phase phase;
+    phase.name = currentPhase;
+    phase.wallMs = phaseTimer.elapsed();
+    qint64 cpuEnd = processCpuMs();
+    phase.cpuMs = (cpuEnd < 0 || phaseCpuStart < 0) ? -1 : cpuEnd - phaseCpuStart;
+    phase.peakRssKb = processPeakRssKb();
+    phases.push_back(phase);
+    currentPhase.clear();
+}
+
+bool StartupProfiler::writeReport(const std::string &filename) const
+{
+    using namespace json_spirit;
+
+    Array report;
+    qint64 totalCpuMs = 0;
+    for(std::vector<Phase>::const_iterator it = phases.begin(); it != phases.end(); ++it)
+    {
+        Object phase;
+        phase.push_back(Pair("phase", it->name));
+        phase.push_back(Pair("wall_ms", (boost::int64_t)it->wallMs));
+        phase.push_back(Pair("cpu_ms", (boost::int64_t)it->cpuMs));
+        phase.push_back(Pair("peak_rss_kb", (boost::int64_t)it->peakRssKb));
+        report.push_back(phase);
+        if(it->cpuMs > 0)
+            totalCpuMs += it->cpuMs;
+    }
+
+    Object root;
+    root.push_back(Pair("phases", report));
+    root.push_back(Pair("total_wall_ms", (boost::int64_t)totalTimer.elapsed()));
+    root.push_back(Pair("total_cpu_ms", (boost::int64_t)totalCpuMs));
+    root.push_back(Pair("peak_rss_kb", (boost::int64_t)processPeakRssKb()));
+
+    std::ofstream file(filename.c_str());
+    if(!file)
+        return false;
+    file << write_formatted(root) << "\n";
+    return file.good();
+}
+
+void StartupProfiler::finish()
+{
+    endPhase();
+    if(!reportFile.empty() && !writeReport(reportFile))
+        printf("Could not write startup profile to %s\n", reportFile.c_str());
+}
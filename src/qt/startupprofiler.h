@@ -0,0 +1,51 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+#include <string>
+#include <vector>
+
+/** Records wall time, CPU time and peak resident memory for each phase of the application startup,
+    and writes them as a JSON report. Phases are consecutive: starting a phase ends the previous one.
+ */
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StartupProfiler(QObject *parent = 0);
+
+    struct Phase
+    {
+        std::string name;
+        qint64 wallMs;      // Wall clock time spent in the phase
+        qint64 cpuMs;       // User and system CPU time spent in the phase, -1 if unsupported
+        qint64 peakRssKb;   // Peak resident set size at the end of the phase, -1 if unsupported
+    };
+
+    /** Start a new phase, ending the current one. */
+    void beginPhase(const std::string &name);
+    /** End the current phase, if any. */
+    void endPhase();
+
+    const std::vector<Phase> &getPhases() const { return phases; }
+
+    /** Write the report to filename when finish() is called, empty to not write a report. */
+    void setReportFile(const std::string &filename) { reportFile = filename; }
+    bool writeReport(const std::string &filename) const;
+
+public slots:
+    /** End the last phase and write the report, if requested. */
+    void finish();
+
+private:
+    QElapsedTimer totalTimer;
+    QElapsedTimer phaseTimer;
+    qint64 phaseCpuStart;
+    std::string currentPhase;
+    std::vector<Phase> phases;
+    std::string reportFile;
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,99 @@
+#include "syncdiagnosticsdialog.h"
+#include "ui_syncdiagnosticsdialog.h"
+#include "clientmodel.h"
+#include "synctablemodel.h"
+#include "csvmodelwriter.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QHeaderView>
+#include <QDir>
+
+SyncDiagnosticsDialog::SyncDiagnosticsDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::SyncDiagnosticsDialog),
+    model(0)
+{
+    ui->setupUi(this);
+}
+
+SyncDiagnosticsDialog::~SyncDiagnosticsDialog()
+{
+    delete ui;
+}
+
+void SyncDiagnosticsDialog::setModel(ClientModel *model)
+{
+    this->model = model;
+    if(!model)
+        return;
+
+    SyncTableModel *syncTable = model->getSyncTableModel();
+    ui->tableView->setModel(syncTable);
+    ui->tableView->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+    ui->tableView->scrollToBottom();
+
+    connect(syncTable, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateSummary()));
+    connect(syncTable, SIGNAL(rowsInserted(QModelIndex,int,int)), ui->tableView, SLOT(scrollToBottom()));
+    updateSummary();
+}
+
+void SyncDiagnosticsDialog::updateSummary()
+{
+    const SyncSample *sample = model ? model->getSyncTableModel()->lastSample() : 0;
+    if(!sample)
+    {
+        ui->blocksLabel->setText(tr("Waiting for the first sample..."));
+        ui->rateLabel->clear();
+        ui->etaLabel->clear();
+        return;
+    }
+
+    ui->blocksLabel->setText(tr("%1 of %2").arg(sample->numBlocks).arg(sample->numBlocksOfPeers));
+    ui->rateLabel->setText(tr("%1 blocks/s, %2 transactions/s, %3 kB/s")
+                           .arg(sample->blocksPerSecond, 0, 'f', 2)
+                           .arg(sample->transactionsPerSecond, 0, 'f', 1)
+                           .arg(sample->bytesPerSecond / 1000, 0, 'f', 1));
+
+    if(sample->secondsRemaining == 0)
+        ui->etaLabel->setText(tr("Up to date"));
+    else if(sample->secondsRemaining < 0)
+        ui->etaLabel->setText(tr("Unknown"));
+    else if(sample->secondsRemaining < 60*60)
+        ui->etaLabel->setText(tr("%n minute(s)", "", sample->secondsRemaining/60 + 1));
+    else
+        ui->etaLabel->setText(tr("%n hour(s)", "", sample->secondsRemaining/(60*60)));
+}
+
+void SyncDiagnosticsDialog::on_exportButton_clicked()
+{
+    if(!model)
+        return;
+
+    // CSV is currently the only supported format
+    QString filename = QFileDialog::getSaveFileName(
+            this,
+            tr("Export Synchronization Samples"),
+            QDir::currentPath(),
+            tr("Comma separated file (*.csv)"));
+
+    if (filename.isNull()) return;
+
+    CSVModelWriter writer(filename);
+
+    // name, column, role
+    writer.setModel(model->getSyncTableModel());
+    writer.addColumn(tr("Time"), SyncTableModel::Time);
+    writer.addColumn(tr("Blocks"), SyncTableModel::Blocks);
+    writer.addColumn(tr("Blocks of peers"), SyncTableModel::BlocksOfPeers);
+    writer.addColumn(tr("Blocks/s"), SyncTableModel::BlocksPerSecond);
+    writer.addColumn(tr("Transactions/s"), SyncTableModel::TransactionsPerSecond);
+    writer.addColumn(tr("Bytes/s"), SyncTableModel::BytesPerSecond);
+    writer.addColumn(tr("Seconds remaining"), SyncTableModel::SecondsRemaining);
+
+    if(!writer.write())
+    {
+        QMessageBox::critical(this, tr("Error exporting"), tr("Could not write to file %1.").arg(filename),
+                              QMessageBox::Abort, QMessageBox::Abort);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SYNCDIAGNOSTICSDIALOG_H
+#define SYNCDIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+
+namespace Ui {
+    class SyncDiagnosticsDialog;
+}
+class ClientModel;
+
+/** Shows the block chain synchronization throughput and estimated time left, with the
+    sampled time series, which can be exported to CSV.
+ */
+class SyncDiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SyncDiagnosticsDialog(QWidget *parent = 0);
+    ~SyncDiagnosticsDialog();
+
+    void setModel(ClientModel *model);
+
+private:
+    Ui::SyncDiagnosticsDialog *ui;
+    ClientModel *model;
+
+private slots:
+    void updateSummary();
+    void on_exportButton_clicked();
+};
+
+#endif // SYNCDIAGNOSTICSDIALOG_H
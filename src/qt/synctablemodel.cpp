@@ -0,0 +1,133 @@
+#include "synctablemodel.h"
+#include "guiconstants.h"
+
+#include <algorithm>
+
+/* Weight of the newest rate in the smoothed rate used for the time estimate */
+static const double SYNC_RATE_SMOOTHING = 0.2;
+
+SyncEstimator::SyncEstimator():
+    fFirst(true), smoothedBlocksPerSecond(0)
+{
+}
+
+void SyncEstimator::estimate(SyncSample &sample, int newBlocks, qint64 numTransactions, qint64 numBytes, double seconds)
+{
+    sample.blocksPerSecond = std::max(0, newBlocks) / seconds;
+    sample.transactionsPerSecond = numTransactions / seconds;
+    sample.bytesPerSecond = numBytes / seconds;
+
+    // Exponential moving average, so that a single slow or fast interval does not make the estimate jump
+    if(fFirst)
+        smoothedBlocksPerSecond = sample.blocksPerSecond;
+    else
+        smoothedBlocksPerSecond += SYNC_RATE_SMOOTHING * (sample.blocksPerSecond - smoothedBlocksPerSecond);
+    fFirst = false;
+
+    int blocksRemaining = sample.numBlocksOfPeers - sample.numBlocks;
+    if(blocksRemaining <= 0)
+        sample.secondsRemaining = 0;
+    else if(smoothedBlocksPerSecond > 0)
+        sample.secondsRemaining = (int)(blocksRemaining / smoothedBlocksPerSecond);
+    else
+        sample.secondsRemaining = -1;
+}
+
+SyncTableModel::SyncTableModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+    columns << tr("Time") << tr("Blocks") << tr("Blocks of peers") << tr("Blocks/s")
+            << tr("Transactions/s") << tr("Bytes/s") << tr("Seconds remaining");
+}
+
+int SyncTableModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return samples.size();
+}
+
+int SyncTableModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return columns.size();
+}
+
+QVariant SyncTableModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= samples.size())
+        return QVariant();
+    const SyncSample &sample = samples.at(index.row());
+
+    if(role == Qt::DisplayRole)
+    {
+        switch(index.column())
+        {
+        case Time:
+            return sample.time.toString(Qt::ISODate);
+        case Blocks:
+            return sample.numBlocks;
+        case BlocksOfPeers:
+            return sample.numBlocksOfPeers;
+        case BlocksPerSecond:
+            return QString::number(sample.blocksPerSecond, 'f', 2);
+        case TransactionsPerSecond:
+            return QString::number(sample.transactionsPerSecond, 'f', 1);
+        case BytesPerSecond:
+            return QString::number(sample.bytesPerSecond, 'f', 0);
+        case SecondsRemaining:
+            return sample.secondsRemaining < 0 ? QVariant() : QVariant(sample.secondsRemaining);
+        }
+    }
+    else if(role == Qt::EditRole)
+    {
+        // Unformatted values, used for export
+        switch(index.column())
+        {
+        case Time:
+            return sample.time.toString(Qt::ISODate);
+        case Blocks:
+            return sample.numBlocks;
+        case BlocksOfPeers:
+            return sample.numBlocksOfPeers;
+        case BlocksPerSecond:
+            return sample.blocksPerSecond;
+        case TransactionsPerSecond:
+            return sample.transactionsPerSecond;
+        case BytesPerSecond:
+            return sample.bytesPerSecond;
+        case SecondsRemaining:
+            return sample.secondsRemaining;
+        }
+    }
+    else if(role == Qt::TextAlignmentRole)
+    {
+        if(index.column() != Time)
+            return (int)(Qt::AlignRight|Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant SyncTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole && section < columns.size())
+        return columns[section];
+    return QVariant();
+}
+
+void SyncTableModel::addSample(const SyncSample &sample)
+{
+    if(samples.size() >= MAX_SYNC_SAMPLES)
+    {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        samples.removeFirst();
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), samples.size(), samples.size());
+    samples.append(sample);
+    endInsertRows();
+}
+
+const SyncSample *SyncTableModel::lastSample() const
+{
+    return samples.isEmpty() ? 0 : &samples.last();
+}
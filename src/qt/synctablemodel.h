@@ -0,0 +1,76 @@
+#ifndef SYNCTABLEMODEL_H
+#define SYNCTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QDateTime>
+#include <QList>
+
+/** One sample of the block chain synchronization progress. Rates are averaged over the
+    interval since the previous sample.
+ */
+struct SyncSample
+{
+    QDateTime time;
+    int numBlocks;
+    int numBlocksOfPeers;
+    double blocksPerSecond;
+    double transactionsPerSecond;
+    double bytesPerSecond;
+    /** Smoothed estimate of the seconds until synchronized, -1 if unknown */
+    int secondsRemaining;
+};
+
+/** Rates and smoothed time estimate of successive synchronization samples.
+ */
+class SyncEstimator
+{
+public:
+    SyncEstimator();
+
+    /** Fill in the rates and time estimate of a sample, whose numBlocks and numBlocksOfPeers are set,
+        from the blocks, transactions and bytes that came in over the seconds since the previous sample.
+     */
+    void estimate(SyncSample &sample, int newBlocks, qint64 numTransactions, qint64 numBytes, double seconds);
+
+    double getSmoothedBlocksPerSecond() const { return smoothedBlocksPerSecond; }
+
+private:
+    bool fFirst;
+    double smoothedBlocksPerSecond;
+};
+
+/** Time series of synchronization samples, oldest first, with a bounded number of rows.
+ */
+class SyncTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit SyncTableModel(QObject *parent = 0);
+
+    enum ColumnIndex {
+        Time = 0,
+        Blocks = 1,
+        BlocksOfPeers = 2,
+        BlocksPerSecond = 3,
+        TransactionsPerSecond = 4,
+        BytesPerSecond = 5,
+        SecondsRemaining = 6
+    };
+
+    int rowCount(const QModelIndex &parent) const;
+    int columnCount(const QModelIndex &parent) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+    /** Append a sample, dropping the oldest one if the table is full */
+    void addSample(const SyncSample &sample);
+    /** Most recent sample, or 0 if there is none */
+    const SyncSample *lastSample() const;
+
+private:
+    QStringList columns;
+    QList<SyncSample> samples;
+};
+
+#endif // SYNCTABLEMODEL_H
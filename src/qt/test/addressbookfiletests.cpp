@@ -0,0 +1,102 @@
+#include "addressbookfiletests.h"
+#include "../addressbookfile.h"
+
+typedef WalletInterface::AddressBookEntry Entry;
+
+void AddressBookFileTests::csvTests()
+{
+    QList<Entry> entries;
+    QString error;
+
+    // Our own export format
+    QVERIFY(AddressBookFile::parseCSV("\"Label\",\"Address\"\n"
+                                      "\"Alice\",\"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"\n"
+                                      "\"Bob, \"\"the builder\"\"\",\"37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare\"\n", entries, error));
+    QCOMPARE(entries.size(), 2);
+    QVERIFY(entries.at(0).label == QString("Alice"));
+    QVERIFY(entries.at(0).address == QString("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa"));
+    QVERIFY(entries.at(1).label == QString("Bob, \"the builder\""));
+    QVERIFY(entries.at(1).address == QString("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare"));
+    QVERIFY(!entries.at(0).mine && !entries.at(1).mine);
+
+    // Columns in another order, found by the header
+    entries.clear();
+    QVERIFY(AddressBookFile::parseCSV("address,label\r\n1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa,Alice\r\n", entries, error));
+    QCOMPARE(entries.size(), 1);
+    QVERIFY(entries.at(0).label == QString("Alice"));
+    QVERIFY(entries.at(0).address == QString("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa"));
+
+    // Plain list of addresses, blank lines are skipped
+    entries.clear();
+    QVERIFY(AddressBookFile::parseCSV("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\n\n37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare", entries, error));
+    QCOMPARE(entries.size(), 2);
+    QVERIFY(entries.at(0).label.isEmpty());
+    QVERIFY(entries.at(1).address == QString("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare"));
+
+    // Addresses are not validated here
+    entries.clear();
+    QVERIFY(AddressBookFile::parseCSV("Label,Address\nx,notanaddress\n", entries, error));
+    QCOMPARE(entries.size(), 1);
+
+    // Errors name the line in the file, counting a line break inside a quoted label
+    entries.clear();
+    QVERIFY(!AddressBookFile::parseCSV("Label,Address\n\"two\nlines\",1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\n\nno address\n", entries, error));
+    QVERIFY(error.contains("5"));
+    QVERIFY(!AddressBookFile::parseCSV("Label,Address\n\"unterminated,1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\n", entries, error));
+    QVERIFY(error.contains("2"));
+}
+
+void AddressBookFileTests::jsonTests()
+{
+    QList<Entry> entries;
+    QString error;
+
+    QVERIFY(AddressBookFile::parseJSON("[{\"label\": \"Alice\", \"address\": \"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"},"
+                                       " {\"address\": \"37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare\", \"label\": null},"
+                                       " {\"address\": \"mmbqosg782sN9skgHX5EUrTUNQTKSLWHMN\"}]", entries, error));
+    QCOMPARE(entries.size(), 3);
+    QVERIFY(entries.at(0).label == QString("Alice"));
+    QVERIFY(entries.at(0).address == QString("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa"));
+    QVERIFY(entries.at(1).label.isEmpty());
+    QVERIFY(entries.at(2).label.isEmpty());
+    QVERIFY(entries.at(2).address == QString("mmbqosg782sN9skgHX5EUrTUNQTKSLWHMN"));
+
+    // Non-ASCII labels are UTF-8
+    entries.clear();
+    QVERIFY(AddressBookFile::parseJSON(QString::fromUtf8("[{\"label\": \"Caf\xc3\xa9\", \"address\": \"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"}]"), entries, error));
+    QVERIFY(entries.at(0).label == QString::fromUtf8("Caf\xc3\xa9"));
+
+    QVERIFY(!AddressBookFile::parseJSON("{\"address\": \"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"}", entries, error));
+    QVERIFY(!AddressBookFile::parseJSON("[\"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"]", entries, error));
+    QVERIFY(!AddressBookFile::parseJSON("[{\"label\": \"Alice\"}]", entries, error));
+    QVERIFY(!AddressBookFile::parseJSON("[{\"label\": 1, \"address\": \"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\"}]", entries, error));
+    QVERIFY(!AddressBookFile::parseJSON("not json", entries, error));
+}
+
+void AddressBookFileTests::roundTripTests()
+{
+    QList<Entry> entries;
+    entries.append(Entry("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", "Alice", false));
+    entries.append(Entry("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare", "Bob, \"the builder\"\nsecond line", false));
+    entries.append(Entry("mmbqosg782sN9skgHX5EUrTUNQTKSLWHMN", QString(), false));
+    entries.append(Entry("1111111111111111111114oLvT2", QString::fromUtf8("Caf\xc3\xa9"), false));
+
+    QList<Entry> csv, json;
+    QString error;
+    QVERIFY(AddressBookFile::parseCSV(AddressBookFile::toCSV(entries), csv, error));
+    QVERIFY(AddressBookFile::parseJSON(AddressBookFile::toJSON(entries), json, error));
+    QCOMPARE(csv.size(), entries.size());
+    QCOMPARE(json.size(), entries.size());
+    for(int i = 0; i < entries.size(); ++i)
+    {
+        QVERIFY(csv.at(i).address == entries.at(i).address);
+        QVERIFY(csv.at(i).label == entries.at(i).label);
+        QVERIFY(json.at(i).address == entries.at(i).address);
+        QVERIFY(json.at(i).label == entries.at(i).label);
+    }
+
+    QVERIFY(AddressBookFile::formatForFile("addresses.json") == AddressBookFile::JSON);
+    QVERIFY(AddressBookFile::formatForFile("addresses.JSON") == AddressBookFile::JSON);
+    QVERIFY(AddressBookFile::formatForFile("addresses.csv") == AddressBookFile::CSV);
+    QVERIFY(AddressBookFile::formatForFile("addresses") == AddressBookFile::CSV);
+}
@@ -0,0 +1,17 @@
+#ifndef ADDRESSBOOKFILETESTS_H
+#define ADDRESSBOOKFILETESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class AddressBookFileTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void csvTests();
+    void jsonTests();
+    void roundTripTests();
+};
+
+#endif // ADDRESSBOOKFILETESTS_H
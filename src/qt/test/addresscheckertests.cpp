@@ -0,0 +1,68 @@
+#include "addresscheckertests.h"
+#include "../addresschecker.h"
+
+#include <cstring>
+
+// Address of the genesis block coinbase key and its hash160
+static const char *GENESIS_ADDRESS = "1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa";
+static const unsigned char GENESIS_HASH160[20] = {
+    0x62, 0xe9, 0x07, 0xb1, 0x5c, 0xbf, 0x27, 0xd5, 0x42, 0x53,
+    0x99, 0xeb, 0xf6, 0xf0, 0xfb, 0x50, 0xeb, 0xb8, 0x8f, 0x18
+};
+
+void AddressCheckerTests::checkTests()
+{
+    QVERIFY(AddressChecker::check(GENESIS_ADDRESS) == AddressChecker::Valid);
+    QVERIFY(AddressChecker::check(GENESIS_ADDRESS, 0) == AddressChecker::Valid);
+    QVERIFY(AddressChecker::check(GENESIS_ADDRESS, 111) == AddressChecker::WrongVersion);
+    QVERIFY(AddressChecker::version(GENESIS_ADDRESS) == 0);
+    QVERIFY(AddressChecker::check("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare", 5) == AddressChecker::Valid);
+    QVERIFY(AddressChecker::version("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare") == 5);
+    QVERIFY(AddressChecker::check("mmbqosg782sN9skgHX5EUrTUNQTKSLWHMN", 111) == AddressChecker::Valid);
+    QVERIFY(AddressChecker::check("1111111111111111111114oLvT2") == AddressChecker::Valid);
+
+    // Last character changed
+    QVERIFY(AddressChecker::check("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNb") == AddressChecker::InvalidChecksum);
+    QVERIFY(AddressChecker::version("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNb") == -1);
+    // 0, O, I and l are not in the alphabet
+    QVERIFY(AddressChecker::check("1A1zP1eP5QGefi2DMPTfTL5SLmv7Div0Na") == AddressChecker::InvalidCharacter);
+    QVERIFY(AddressChecker::check("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfN ") == AddressChecker::InvalidCharacter);
+    QVERIFY(AddressChecker::check(QString::fromUtf8("1A1zP1eP5QGefi2DMPTfTL5SLmv7Div\xc3\xa9Na")) == AddressChecker::InvalidCharacter);
+    // Too short, too long and an extra leading zero byte
+    QVERIFY(AddressChecker::check("1A1zP1eP5QGefi2DMPTfTL5SLmv7Div") == AddressChecker::InvalidLength);
+    QVERIFY(AddressChecker::check("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNaNa") == AddressChecker::InvalidLength);
+    QVERIFY(AddressChecker::check("11A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa") == AddressChecker::InvalidLength);
+    QVERIFY(AddressChecker::check("") == AddressChecker::InvalidLength);
+}
+
+void AddressCheckerTests::encodeTests()
+{
+    QVERIFY(AddressChecker::encode(0, GENESIS_HASH160) == QString(GENESIS_ADDRESS));
+    QVERIFY(AddressChecker::encode(5, GENESIS_HASH160).startsWith('3'));
+    QVERIFY(AddressChecker::check(AddressChecker::encode(5, GENESIS_HASH160), 5) == AddressChecker::Valid);
+
+    unsigned char zero[20];
+    memset(zero, 0, sizeof(zero));
+    QVERIFY(AddressChecker::encode(0, zero) == QString("1111111111111111111114oLvT2"));
+
+    // Decoding gives back the version and hash
+    unsigned char decoded[AddressChecker::DECODED_SIZE];
+    QString address(GENESIS_ADDRESS);
+    QVERIFY(AddressChecker::decode(address.constData(), address.size(), decoded) == AddressChecker::InvalidChecksum);
+    QVERIFY(AddressChecker::verifyChecksum(decoded));
+    QVERIFY(decoded[0] == 0);
+    QVERIFY(memcmp(decoded + 1, GENESIS_HASH160, 20) == 0);
+}
+
+void AddressCheckerTests::batchTests()
+{
+    // Enough addresses for several chunks, with an invalid one at every seventh position
+    QStringList addresses;
+    for(int i = 0; i < 1000; ++i)
+        addresses.append(i % 7 ? GENESIS_ADDRESS : "1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNb");
+    QVector<AddressChecker::Result> results = AddressChecker::checkBatch(addresses);
+    QCOMPARE(results.size(), addresses.size());
+    for(int i = 0; i < results.size(); ++i)
+        QVERIFY(results.at(i) == (i % 7 ? AddressChecker::Valid : AddressChecker::InvalidChecksum));
+    QVERIFY(AddressChecker::checkBatch(QStringList()).isEmpty());
+}
@@ -0,0 +1,17 @@
+#ifndef ADDRESSCHECKERTESTS_H
+#define ADDRESSCHECKERTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class AddressCheckerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void checkTests();
+    void encodeTests();
+    void batchTests();
+};
+
+#endif // ADDRESSCHECKERTESTS_H
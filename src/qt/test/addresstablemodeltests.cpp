@@ -0,0 +1,276 @@
+#include "addresstablemodeltests.h"
+#include "../addresstablemodel.h"
+#include "../addresschecker.h"
+#include "../bench/syntheticwallet.h"
+
+#include <QSignalSpy>
+
+#include <cstring>
+
+static QString addressAt(const AddressTableModel &model, int row)
+{
+    return model.data(model.index(row, AddressTableModel::Address, QModelIndex()), Qt::EditRole).toString();
+}
+
+static QString labelAt(const AddressTableModel &model, int row)
+{
+    return model.data(model.index(row, AddressTableModel::Label, QModelIndex()), Qt::EditRole).toString();
+}
+
+// Address that the synthetic wallet does not generate
+static QString fixedAddress(unsigned char n)
+{
+    unsigned char hash160[20];
+    memset(hash160, n, sizeof(hash160));
+    return AddressChecker::encode(0, hash160);
+}
+
+// Every row must be found at its own number
+static void checkRowIndex(const AddressTableModel &model)
+{
+    for(int row = 0; row < model.rowCount(QModelIndex()); ++row)
+        QCOMPARE(model.lookupAddress(addressAt(model, row)), row);
+}
+
+static int firstSendingRow(const AddressTableModel &model, int from)
+{
+    for(int row = from; row < model.rowCount(QModelIndex()); ++row)
+        if(!model.isReceiving(row))
+            return row;
+    return -1;
+}
+
+static void checkRange(const QSignalSpy &spy, int signal, int first, int last)
+{
+    QCOMPARE(spy.at(signal).at(1).toInt(), first);
+    QCOMPARE(spy.at(signal).at(2).toInt(), last);
+}
+
+static void checkChanged(const QSignalSpy &spy, int signal, int row)
+{
+    QModelIndex topLeft = qvariant_cast<QModelIndex>(spy.at(signal).at(0));
+    QModelIndex bottomRight = qvariant_cast<QModelIndex>(spy.at(signal).at(1));
+    QCOMPARE(topLeft.row(), row);
+    QCOMPARE(bottomRight.row(), row);
+    QCOMPARE(topLeft.column(), (int)AddressTableModel::Label);
+    QCOMPARE(bottomRight.column(), (int)AddressTableModel::Address);
+}
+
+void AddressTableModelTests::initTestCase()
+{
+    // Needed to record the arguments of the model signals
+    qRegisterMetaType<QModelIndex>("QModelIndex");
+}
+
+void AddressTableModelTests::updateListTests()
+{
+    SyntheticWallet wallet(0, 20);
+    AddressTableModel model(&wallet);
+    QCOMPARE(model.rowCount(QModelIndex()), 20);
+    checkRowIndex(model);
+
+    // Remove rows 3 to 5 and 10 from the book, relabel row 0 and add a sending and a receiving entry
+    QStringList removed;
+    removed << addressAt(model, 3) << addressAt(model, 4) << addressAt(model, 5) << addressAt(model, 10);
+    foreach(const QString &address, removed)
+        wallet.delAddressBookName(address);
+    QString relabeled = addressAt(model, 0);
+    wallet.setAddressBookName(relabeled, "Relabeled");
+    QString sending = fixedAddress(1);
+    wallet.setAddressBookName(sending, "New contact");
+    QString receiving;
+    QVERIFY(wallet.getNewAddress(receiving));
+
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    model.updateList();
+
+    // Removed from the back, a range of adjacent rows at a time
+    QCOMPARE(removedSpy.count(), 2);
+    checkRange(removedSpy, 0, 10, 10);
+    checkRange(removedSpy, 1, 3, 5);
+    // New entries are appended with a single insertion
+    QCOMPARE(insertedSpy.count(), 1);
+    checkRange(insertedSpy, 0, 16, 17);
+    // Only the relabeled row changed
+    QCOMPARE(changedSpy.count(), 1);
+    checkChanged(changedSpy, 0, 0);
+    QCOMPARE(labelAt(model, 0), QString("Relabeled"));
+
+    QCOMPARE(model.rowCount(QModelIndex()), 18);
+    checkRowIndex(model);
+    foreach(const QString &address, removed)
+        QCOMPARE(model.lookupAddress(address), -1);
+    QVERIFY(model.lookupAddress(sending) >= 16);
+    QVERIFY(!model.isReceiving(model.lookupAddress(sending)));
+    QVERIFY(model.lookupAddress(receiving) >= 16);
+    QVERIFY(model.isReceiving(model.lookupAddress(receiving)));
+
+    // Without changes in the book nothing is signalled
+    removedSpy.clear();
+    insertedSpy.clear();
+    changedSpy.clear();
+    model.updateList();
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 0);
+}
+
+void AddressTableModelTests::updateEntryTests()
+{
+    SyntheticWallet wallet(0, 8);
+    AddressTableModel model(&wallet);
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+
+    QString address = fixedAddress(2);
+    model.updateEntry(address, "Contact", false);
+    QCOMPARE(insertedSpy.count(), 1);
+    checkRange(insertedSpy, 0, 8, 8);
+    QCOMPARE(model.lookupAddress(address), 8);
+    QVERIFY(!model.isReceiving(8));
+
+    // The same entry again is no change
+    model.updateEntry(address, "Contact", false);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(changedSpy.count(), 0);
+
+    // A new label, then the key turns up
+    model.updateEntry(address, "Renamed", false);
+    QCOMPARE(changedSpy.count(), 1);
+    checkChanged(changedSpy, 0, 8);
+    QCOMPARE(labelAt(model, 8), QString("Renamed"));
+    model.updateEntry(address, "Renamed", true);
+    QCOMPARE(changedSpy.count(), 2);
+    checkChanged(changedSpy, 1, 8);
+    QVERIFY(model.isReceiving(8));
+
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(model.rowCount(QModelIndex()), 9);
+    checkRowIndex(model);
+}
+
+void AddressTableModelTests::removeRowsTests()
+{
+    SyntheticWallet wallet(0, 20);
+    AddressTableModel model(&wallet);
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // Receiving addresses, several rows at once and rows past the end are refused
+    int receivingRow = 0;
+    while(!model.isReceiving(receivingRow))
+        ++receivingRow;
+    QVERIFY(!model.removeRows(receivingRow, 1));
+    QVERIFY(!model.removeRows(firstSendingRow(model, 0), 2));
+    QVERIFY(!model.removeRows(20, 1));
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(model.rowCount(QModelIndex()), 20);
+
+    // Remove sending rows from the middle, the rows after them move up
+    for(int n = 0; n < 3; ++n)
+    {
+        int row = firstSendingRow(model, 5);
+        QVERIFY(row != -1);
+        QString address = addressAt(model, row);
+        QString next = addressAt(model, row + 1);
+        QVERIFY(model.removeRows(row, 1));
+        QCOMPARE(removedSpy.count(), n + 1);
+        checkRange(removedSpy, n, row, row);
+        QCOMPARE(model.lookupAddress(address), -1);
+        QVERIFY(!wallet.haveAddressBookEntry(address));
+        QCOMPARE(model.lookupAddress(next), row);
+        checkRowIndex(model);
+    }
+    QCOMPARE(model.rowCount(QModelIndex()), 17);
+}
+
+void AddressTableModelTests::setDataTests()
+{
+    SyntheticWallet wallet(0, 20);
+    AddressTableModel model(&wallet);
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+
+    int row = firstSendingRow(model, 0);
+    int other = firstSendingRow(model, row + 1);
+    QString address = addressAt(model, row);
+    QString otherAddress = addressAt(model, other);
+    QString label = labelAt(model, row);
+    QModelIndex index = model.index(row, AddressTableModel::Address, QModelIndex());
+
+    // An address that is already in the book is refused, and both entries stay as they are
+    QVERIFY(!model.setData(index, otherAddress, Qt::EditRole));
+    QCOMPARE(model.getEditStatus(), AddressTableModel::DUPLICATE_ADDRESS);
+    QCOMPARE(changedSpy.count(), 0);
+    QCOMPARE(addressAt(model, row), address);
+    QCOMPARE(model.lookupAddress(address), row);
+    QCOMPARE(model.lookupAddress(otherAddress), other);
+    QVERIFY(wallet.haveAddressBookEntry(address));
+    QVERIFY(wallet.haveAddressBookEntry(otherAddress));
+
+    // The same address is accepted without a change
+    QVERIFY(model.setData(index, address, Qt::EditRole));
+    QCOMPARE(model.getEditStatus(), AddressTableModel::OK);
+    QCOMPARE(model.lookupAddress(address), row);
+
+    // A new address replaces the old one in the same row, with the same label
+    QString replacement = fixedAddress(3);
+    QVERIFY(model.setData(index, replacement, Qt::EditRole));
+    QCOMPARE(model.getEditStatus(), AddressTableModel::OK);
+    QCOMPARE(changedSpy.count(), 2);
+    checkChanged(changedSpy, 1, row);
+    QCOMPARE(addressAt(model, row), replacement);
+    QCOMPARE(model.lookupAddress(replacement), row);
+    QCOMPARE(model.lookupAddress(address), -1);
+    QVERIFY(!wallet.haveAddressBookEntry(address));
+    QCOMPARE(wallet.labelForAddress(replacement), label);
+
+    // The replaced address can be used again
+    QVERIFY(model.setData(model.index(other, AddressTableModel::Address, QModelIndex()), address, Qt::EditRole));
+    QCOMPARE(model.getEditStatus(), AddressTableModel::OK);
+    QCOMPARE(model.lookupAddress(address), other);
+
+    // Labels are written through to the wallet
+    QVERIFY(model.setData(model.index(row, AddressTableModel::Label, QModelIndex()), QString("Edited"), Qt::EditRole));
+    QCOMPARE(wallet.labelForAddress(replacement), QString("Edited"));
+    QCOMPARE(labelAt(model, row), QString("Edited"));
+
+    QCOMPARE(model.rowCount(QModelIndex()), 20);
+    checkRowIndex(model);
+}
+
+void AddressTableModelTests::importTests()
+{
+    SyntheticWallet wallet(0, 8);
+    AddressTableModel model(&wallet);
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    // One of our own addresses that is not in the book
+    QString own;
+    QVERIFY(wallet.getNewAddress(own));
+    wallet.delAddressBookName(own);
+    QString foreign = fixedAddress(4);
+
+    QList<WalletInterface::AddressBookEntry> entries;
+    entries << WalletInterface::AddressBookEntry(foreign, "Foreign", false)
+            << WalletInterface::AddressBookEntry(own, "Own", false)
+            << WalletInterface::AddressBookEntry(addressAt(model, 0), "In the book", false)
+            << WalletInterface::AddressBookEntry(foreign, "Again", false)
+            << WalletInterface::AddressBookEntry("not an address", "Invalid", false);
+    AddressTableModel::ImportResult result = model.importAddresses(entries);
+    QCOMPARE(result.imported, 2);
+    QCOMPARE(result.duplicate, 2);
+    QCOMPARE(result.invalid, 1);
+    QVERIFY(!result.writeFailed);
+
+    QCOMPARE(insertedSpy.count(), 1);
+    checkRange(insertedSpy, 0, 8, 9);
+    QCOMPARE(model.lookupAddress(foreign), 8);
+    QCOMPARE(model.lookupAddress(own), 9);
+    QVERIFY(!model.isReceiving(8));
+    // Our own address is imported as a receiving address, of which only the label can be edited
+    QVERIFY(model.isReceiving(9));
+    QVERIFY(!(model.flags(model.index(9, AddressTableModel::Address, QModelIndex())) & Qt::ItemIsEditable));
+    QCOMPARE(wallet.labelForAddress(own), QString("Own"));
+    checkRowIndex(model);
+}
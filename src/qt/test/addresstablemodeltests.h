@@ -0,0 +1,20 @@
+#ifndef ADDRESSTABLEMODELTESTS_H
+#define ADDRESSTABLEMODELTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class AddressTableModelTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void updateListTests();
+    void updateEntryTests();
+    void removeRowsTests();
+    void setDataTests();
+    void importTests();
+};
+
+#endif // ADDRESSTABLEMODELTESTS_H
@@ -0,0 +1,124 @@
+#include "batchclienttests.h"
+#include "../batchclient.h"
+
+#include <sstream>
+
+void BatchClientTests::tokenizeTests()
+{
+    std::vector<std::string> tokens;
+
+    QVERIFY(BatchClient::tokenize("getbalance", tokens));
+    QCOMPARE(tokens.size(), (size_t)1);
+    QCOMPARE(tokens[0], std::string("getbalance"));
+
+    // Repeated spaces separate nothing, quotes keep spaces in a parameter
+    QVERIFY(BatchClient::tokenize("setaccount  1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa \"my account\"", tokens));
+    QCOMPARE(tokens.size(), (size_t)3);
+    QCOMPARE(tokens[1], std::string("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa"));
+    QCOMPARE(tokens[2], std::string("my account"));
+
+    // Escaped quotes
+    QVERIFY(BatchClient::tokenize("signmessage addr \"say \\\"hi\\\"\"", tokens));
+    QCOMPARE(tokens.size(), (size_t)3);
+    QCOMPARE(tokens[2], std::string("say \"hi\""));
+
+    // Quoted empty parameters are kept, CRLF line ends and tabs are separators
+    QVERIFY(BatchClient::tokenize("getbalance \"\"\t6\r", tokens));
+    QCOMPARE(tokens.size(), (size_t)3);
+    QCOMPARE(tokens[1], std::string());
+    QCOMPARE(tokens[2], std::string("6"));
+
+    // Blank lines and comments
+    QVERIFY(!BatchClient::tokenize("", tokens));
+    QVERIFY(!BatchClient::tokenize("   ", tokens));
+    QVERIFY(!BatchClient::tokenize("# getbalance", tokens));
+    QVERIFY(!BatchClient::tokenize("#getbalance", tokens));
+}
+
+void BatchClientTests::readCallsTests()
+{
+    std::istringstream in("getblockcount\n"
+                          "\n"
+                          "# skipped\n"
+                          "getbalance \"\" 6\n"
+                          "getblockhash 100\n");
+    json_spirit::Array calls = BatchClient::readCalls(in);
+    QCOMPARE(calls.size(), (size_t)3);
+
+    const char *methods[] = {"getblockcount", "getbalance", "getblockhash"};
+    for(size_t i = 0; i < calls.size(); ++i)
+    {
+        QVERIFY(calls[i].type() == json_spirit::obj_type);
+        const json_spirit::Object &call = calls[i].get_obj();
+        QCOMPARE(json_spirit::find_value(call, "method").get_str(), std::string(methods[i]));
+
+        // The id is replaced by the position of the call, and there is only one
+        int ids = 0;
+        for(size_t j = 0; j < call.size(); ++j)
+        {
+            if(call[j].name_ == "id")
+                ++ids;
+        }
+        QCOMPARE(ids, 1);
+        QCOMPARE(json_spirit::find_value(call, "id").get_int(), (int)i);
+    }
+
+    // Parameters are encoded the same way as for a single call
+    std::vector<std::string> params;
+    params.push_back("");
+    params.push_back("6");
+    json_spirit::Value single;
+    QVERIFY(json_spirit::read(RPC::content("getbalance", params), single));
+    QVERIFY(json_spirit::find_value(calls[1].get_obj(), "params") == json_spirit::find_value(single.get_obj(), "params"));
+}
+
+static json_spirit::Object makeReply(int id, int result)
+{
+    json_spirit::Object reply;
+    reply.push_back(json_spirit::Pair("result", result));
+    reply.push_back(json_spirit::Pair("error", json_spirit::Value()));
+    reply.push_back(json_spirit::Pair("id", id));
+    return reply;
+}
+
+void BatchClientTests::repliesTests()
+{
+    std::vector<json_spirit::Object> replies(4);
+
+    // Replies of a batch come in any order, ids of other batches are ignored
+    json_spirit::Array batch;
+    batch.push_back(makeReply(3, 30));
+    batch.push_back(makeReply(2, 20));
+    batch.push_back(makeReply(0, 99));
+    batch.push_back(makeReply(7, 99));
+    batch.push_back(json_spirit::Value("garbage"));
+    BatchClient::storeReplies(batch, 2, 4, replies);
+    QVERIFY(replies[0].empty());
+    QVERIFY(replies[1].empty());
+    QCOMPARE(json_spirit::find_value(replies[2], "result").get_int(), 20);
+    QCOMPARE(json_spirit::find_value(replies[3], "result").get_int(), 30);
+
+    // The first batch has one failed call and one without reply
+    json_spirit::Object failed;
+    json_spirit::Object error;
+    error.push_back(json_spirit::Pair("code", -5));
+    error.push_back(json_spirit::Pair("message", "Invalid address"));
+    failed.push_back(json_spirit::Pair("result", json_spirit::Value()));
+    failed.push_back(json_spirit::Pair("error", error));
+    failed.push_back(json_spirit::Pair("id", 0));
+    batch.clear();
+    batch.push_back(failed);
+    BatchClient::storeReplies(batch, 0, 2, replies);
+
+    std::ostringstream out;
+    QCOMPARE(BatchClient::writeResults(replies, out), 1);
+    QCOMPARE(out.str(), std::string("error: {\"code\":-5,\"message\":\"Invalid address\"}\n"
+                                    "error: no reply\n"
+                                    "20\n"
+                                    "30\n"));
+
+    // Only successful calls
+    std::ostringstream ok;
+    QCOMPARE(BatchClient::writeResults(std::vector<json_spirit::Object>(replies.begin() + 2, replies.end()), ok), 0);
+    QCOMPARE(ok.str(), std::string("20\n30\n"));
+}
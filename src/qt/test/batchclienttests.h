@@ -0,0 +1,17 @@
+#ifndef BATCHCLIENTTESTS_H
+#define BATCHCLIENTTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class BatchClientTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokenizeTests();
+    void readCallsTests();
+    void repliesTests();
+};
+
+#endif // BATCHCLIENTTESTS_H
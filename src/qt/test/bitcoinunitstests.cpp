@@ -0,0 +1,68 @@
+#include "bitcoinunitstests.h"
+#include "../bitcoinunits.h"
+
+void BitcoinUnitsTests::formatTests()
+{
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 0) == QString("0.00"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 100000000) == QString("1.00"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 150000000) == QString("1.50"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 1) == QString("0.00000001"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, -123456789) == QString("-1.23456789"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 100000000, true) == QString("+1.00"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, 0, true) == QString("0.00"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::mBTC, 100000000) == QString("1000.00"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::uBTC, 1) == QString("0.01"));
+    QVERIFY(BitcoinUnits::formatWithUnit(BitcoinUnits::BTC, 100000000) == QString("1.00 BTC"));
+    QVERIFY(BitcoinUnits::format(-1, 100000000).isEmpty());
+
+    // The most negative amount has no positive counterpart, the magnitude must not overflow
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, Q_INT64_C(-9223372036854775807) - 1) == QString("-92233720368.54775808"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::uBTC, Q_INT64_C(-9223372036854775807) - 1) == QString("-92233720368547758.08"));
+    QVERIFY(BitcoinUnits::format(BitcoinUnits::BTC, Q_INT64_C(9223372036854775807)) == QString("92233720368.54775807"));
+
+    // Longest output fits the buffer of the buffer API
+    QChar buf[BitcoinUnits::MAX_FORMAT_WITH_UNIT_LENGTH];
+    int len = BitcoinUnits::formatWithUnit(BitcoinUnits::uBTC, Q_INT64_C(-9223372036854775807) - 1, true, buf);
+    QVERIFY(len > 0 && len <= BitcoinUnits::MAX_FORMAT_WITH_UNIT_LENGTH);
+}
+
+void BitcoinUnitsTests::parseTests()
+{
+    qint64 value = 0;
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "1", &value) && value == 100000000);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "1.5", &value) && value == 150000000);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "0.00000001", &value) && value == 1);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "-1.23456789", &value) && value == -123456789);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "+2", &value) && value == 200000000);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::mBTC, "1.5", &value) && value == 150000);
+    QVERIFY(BitcoinUnits::parse(BitcoinUnits::BTC, "1", 0));
+
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "0.000000001", &value)); // Exceeds precision
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "1.2.3", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "1,000", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "1e3", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "1.5 ", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, " 1.5", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "1 000", &value));
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "10000000000000", &value)); // Exceeds 63 bits
+    QVERIFY(!BitcoinUnits::parse(BitcoinUnits::BTC, "-92233720368.54775808", &value));
+    QVERIFY(!BitcoinUnits::parse(-1, "1", &value));
+}
+
+void BitcoinUnitsTests::roundTripTests()
+{
+    const qint64 amounts[] = { 0, 1, 10, 99999999, 100000000, 150000000, -1, -123456789,
+                               Q_INT64_C(2100000000000000), Q_INT64_C(-2100000000000000) };
+    foreach(BitcoinUnits::Unit unit, BitcoinUnits::availableUnits())
+    {
+        for(unsigned int i = 0; i < sizeof(amounts) / sizeof(amounts[0]); ++i)
+        {
+            qint64 value = 0;
+            QVERIFY(BitcoinUnits::parse(unit, BitcoinUnits::format(unit, amounts[i]), &value));
+            QCOMPARE(value, amounts[i]);
+            QVERIFY(BitcoinUnits::parse(unit, BitcoinUnits::format(unit, amounts[i], true), &value));
+            QCOMPARE(value, amounts[i]);
+        }
+    }
+}
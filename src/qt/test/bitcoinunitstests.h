@@ -0,0 +1,17 @@
+#ifndef BITCOINUNITSTESTS_H
+#define BITCOINUNITSTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class BitcoinUnitsTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void formatTests();
+    void parseTests();
+    void roundTripTests();
+};
+
+#endif // BITCOINUNITSTESTS_H
@@ -0,0 +1,50 @@
+#include "guiutiltests.h"
+#include "../guiutil.h"
+
+#include <QStringList>
+
+void GUIUtilTests::parseCSVTests()
+{
+    QList<QStringList> records;
+    QList<int> lines;
+
+    // Unquoted fields are trimmed, quoted fields are kept as they are
+    QVERIFY(GUIUtil::parseCSV(" a , b ,c\n\" d \", \"e,f\" ,\"g\"\"h\"\"\"\n", records, &lines));
+    QCOMPARE(records.size(), 2);
+    QVERIFY(records.at(0) == QStringList() << "a" << "b" << "c");
+    QVERIFY(records.at(1) == QStringList() << " d " << "e,f" << "g\"h\"");
+    QVERIFY(lines == QList<int>() << 1 << 2);
+
+    // Empty fields, CRLF line ends, no line break at the end
+    records.clear();
+    lines.clear();
+    QVERIFY(GUIUtil::parseCSV("a,,\"\"\r\n,b", records, &lines));
+    QCOMPARE(records.size(), 2);
+    QVERIFY(records.at(0) == QStringList() << "a" << "" << "");
+    QVERIFY(records.at(1) == QStringList() << "" << "b");
+    QVERIFY(lines == QList<int>() << 1 << 2);
+
+    // Line breaks inside quotes belong to the field, blank lines are skipped but counted
+    records.clear();
+    lines.clear();
+    QVERIFY(GUIUtil::parseCSV("\n\"one\ntwo\",x\n\n\ny\n", records, &lines));
+    QCOMPARE(records.size(), 2);
+    QVERIFY(records.at(0) == QStringList() << "one\ntwo" << "x");
+    QVERIFY(records.at(1) == QStringList() << "y");
+    QVERIFY(lines == QList<int>() << 2 << 6);
+
+    // A quote inside an unquoted field is an ordinary character
+    records.clear();
+    QVERIFY(GUIUtil::parseCSV("a\"b,c", records));
+    QVERIFY(records.at(0) == QStringList() << "a\"b" << "c");
+
+    // An unterminated quote fails, reporting the line its record starts on
+    records.clear();
+    lines.clear();
+    QVERIFY(!GUIUtil::parseCSV("a,b\nc,\"d\ne", records, &lines));
+    QCOMPARE(lines.last(), 2);
+
+    records.clear();
+    QVERIFY(GUIUtil::parseCSV("", records));
+    QVERIFY(records.isEmpty());
+}
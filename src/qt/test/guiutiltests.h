@@ -0,0 +1,15 @@
+#ifndef GUIUTILTESTS_H
+#define GUIUTILTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class GUIUtilTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseCSVTests();
+};
+
+#endif // GUIUTILTESTS_H
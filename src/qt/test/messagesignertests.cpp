@@ -0,0 +1,94 @@
+#include "messagesignertests.h"
+#include "../messagesigner.h"
+
+#include <QTemporaryFile>
+#include <QTextStream>
+
+#include <coinChain/Node.h>
+#include <coinWallet/Wallet.h>
+
+static QString addressOf(const CKey &key)
+{
+    return QString::fromStdString(bitcoin.getAddress(toPubKeyHash(key.GetPubKey())).toString());
+}
+
+void MessageSignerTests::signVerifyTests()
+{
+    CKey key;
+    key.MakeNewKey();
+    QString address = addressOf(key);
+    QString signature;
+    QVERIFY(MessageSigner::sign(bitcoin, key, "Hello, world", signature));
+    QVERIFY(!signature.isEmpty());
+    QVERIFY(MessageSigner::verify(bitcoin, address, "Hello, world", signature) == MessageSigner::OK);
+
+    // Another message or another key recovers another public key
+    QVERIFY(MessageSigner::verify(bitcoin, address, "Hello, world!", signature) == MessageSigner::AddressMismatch);
+    CKey other;
+    other.MakeNewKey();
+    QVERIFY(MessageSigner::verify(bitcoin, addressOf(other), "Hello, world", signature) == MessageSigner::AddressMismatch);
+
+    QVERIFY(MessageSigner::verify(bitcoin, address, "Hello, world", "") == MessageSigner::MalformedSignature);
+    QVERIFY(MessageSigner::verify(bitcoin, address, "Hello, world", signature.left(20)) == MessageSigner::MalformedSignature);
+    QVERIFY(MessageSigner::verify(bitcoin, "notanaddress", "Hello, world", signature) == MessageSigner::InvalidAddress);
+
+    // Empty and non-ASCII messages
+    QVERIFY(MessageSigner::sign(bitcoin, key, "", signature));
+    QVERIFY(MessageSigner::verify(bitcoin, address, "", signature) == MessageSigner::OK);
+    QVERIFY(MessageSigner::sign(bitcoin, key, QString::fromUtf8("Caf\xc3\xa9"), signature));
+    QVERIFY(MessageSigner::verify(bitcoin, address, QString::fromUtf8("Caf\xc3\xa9"), signature) == MessageSigner::OK);
+}
+
+void MessageSignerTests::batchTests()
+{
+    // Enough items for several chunks, every tenth one with a tampered message
+    CKey key;
+    key.MakeNewKey();
+    QString address = addressOf(key);
+    QList<MessageSigner::Item> items;
+    for(int i = 0; i < 100; ++i)
+    {
+        QString message = QString("message %1").arg(i);
+        QString signature;
+        QVERIFY(MessageSigner::sign(bitcoin, key, message, signature));
+        items.append(MessageSigner::Item(address, i % 10 ? message : message + "!", signature));
+    }
+    MessageSigner::verifyBatch(bitcoin, items);
+    QCOMPARE(items.size(), 100);
+    for(int i = 0; i < items.size(); ++i)
+        QVERIFY(items.at(i).result == (i % 10 ? MessageSigner::OK : MessageSigner::AddressMismatch));
+}
+
+void MessageSignerTests::fileTests()
+{
+    QList<MessageSigner::Item> items;
+    items.append(MessageSigner::Item("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", "first, with \"quotes\"", "c2lnbmF0dXJl"));
+    items.append(MessageSigner::Item("37muSN5ZrukVTvyVh3mT5Zc5ew9L9CBare", "second\nline", ""));
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    QVERIFY(MessageSigner::writeFile(file.fileName(), items));
+
+    QList<MessageSigner::Item> read;
+    QString error;
+    QVERIFY(MessageSigner::readFile(file.fileName(), read, error));
+    QCOMPARE(read.size(), items.size());
+    for(int i = 0; i < items.size(); ++i)
+    {
+        QVERIFY(read.at(i).address == items.at(i).address);
+        QVERIFY(read.at(i).message == items.at(i).message);
+        QVERIFY(read.at(i).signature == items.at(i).signature);
+    }
+
+    // Errors name the line in the file, not the record
+    QVERIFY(file.open());
+    file.resize(0);
+    QTextStream out(&file);
+    out << "address,message\n\"1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\",\"two\nlines\"\n\n1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\n";
+    out.flush();
+    file.close();
+    read.clear();
+    QVERIFY(!MessageSigner::readFile(file.fileName(), read, error));
+    QVERIFY(error.contains("5"));
+}
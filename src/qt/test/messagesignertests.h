@@ -0,0 +1,17 @@
+#ifndef MESSAGESIGNERTESTS_H
+#define MESSAGESIGNERTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class MessageSignerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void signVerifyTests();
+    void batchTests();
+    void fileTests();
+};
+
+#endif // MESSAGESIGNERTESTS_H
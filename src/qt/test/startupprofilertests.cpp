@@ -0,0 +1,86 @@
+#include "startupprofilertests.h"
+#include "../startupprofiler.h"
+
+#include <QTemporaryFile>
+
+#include <coinHTTP/RPC.h>
+
+#include <fstream>
+#include <sstream>
+
+void StartupProfilerTests::phaseTests()
+{
+    StartupProfiler profiler;
+    QVERIFY(profiler.getPhases().empty());
+
+    // Ending without a phase records nothing
+    profiler.endPhase();
+    QVERIFY(profiler.getPhases().empty());
+
+    // Starting a phase ends the previous one, phases are not nested
+    profiler.beginPhase("first");
+    profiler.beginPhase("second");
+    QCOMPARE(profiler.getPhases().size(), (size_t)1);
+    QCOMPARE(profiler.getPhases().at(0).name, std::string("first"));
+
+    profiler.endPhase();
+    profiler.endPhase();
+    QCOMPARE(profiler.getPhases().size(), (size_t)2);
+    QCOMPARE(profiler.getPhases().at(1).name, std::string("second"));
+
+    // finish() ends the last phase
+    profiler.beginPhase("third");
+    profiler.finish();
+    QCOMPARE(profiler.getPhases().size(), (size_t)3);
+    QCOMPARE(profiler.getPhases().at(2).name, std::string("third"));
+    for(size_t i = 0; i < profiler.getPhases().size(); ++i)
+        QVERIFY(profiler.getPhases().at(i).wallMs >= 0);
+}
+
+void StartupProfilerTests::reportTests()
+{
+    using namespace json_spirit;
+
+    StartupProfiler profiler;
+    profiler.beginPhase("busy");
+    // Burn some CPU, so that the phase has a measurable CPU time on most platforms
+    volatile quint64 sum = 0;
+    for(quint64 i = 0; i < 50000000; ++i)
+        sum += i;
+    profiler.beginPhase("idle");
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+    profiler.setReportFile(file.fileName().toStdString());
+    profiler.finish();
+
+    std::ifstream in(file.fileName().toLocal8Bit().constData());
+    std::stringstream contents;
+    contents << in.rdbuf();
+    Value value;
+    QVERIFY(read(contents.str(), value));
+    QVERIFY(value.type() == obj_type);
+    const Object &root = value.get_obj();
+
+    // One flat entry per phase, in order
+    Value phases = find_value(root, "phases");
+    QVERIFY(phases.type() == array_type);
+    QCOMPARE(phases.get_array().size(), (size_t)2);
+    const char *names[] = {"busy", "idle"};
+    boost::int64_t wallSum = 0, cpuSum = 0;
+    for(size_t i = 0; i < phases.get_array().size(); ++i)
+    {
+        const Object &phase = phases.get_array()[i].get_obj();
+        QCOMPARE(find_value(phase, "phase").get_str(), std::string(names[i]));
+        QVERIFY(find_value(phase, "wall_ms").type() == int_type);
+        QVERIFY(find_value(phase, "peak_rss_kb").type() == int_type);
+        wallSum += find_value(phase, "wall_ms").get_int64();
+        if(find_value(phase, "cpu_ms").get_int64() > 0)
+            cpuSum += find_value(phase, "cpu_ms").get_int64();
+    }
+
+    // The CPU total is the sum of the phases, the wall total also covers the time between them
+    QCOMPARE(find_value(root, "total_cpu_ms").get_int64(), cpuSum);
+    QVERIFY(find_value(root, "total_wall_ms").get_int64() >= wallSum);
+}
@@ -0,0 +1,16 @@
+#ifndef STARTUPPROFILERTESTS_H
+#define STARTUPPROFILERTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class StartupProfilerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void phaseTests();
+    void reportTests();
+};
+
+#endif // STARTUPPROFILERTESTS_H
@@ -0,0 +1,67 @@
+#include "synctablemodeltests.h"
+#include "../synctablemodel.h"
+
+static SyncSample makeSample(int numBlocks, int numBlocksOfPeers)
+{
+    SyncSample sample;
+    sample.numBlocks = numBlocks;
+    sample.numBlocksOfPeers = numBlocksOfPeers;
+    return sample;
+}
+
+void SyncTableModelTests::estimatorTests()
+{
+    SyncEstimator estimator;
+
+    // The first sample sets the smoothed rate: 100 blocks in 10 s, 1000 blocks to go
+    SyncSample sample = makeSample(100, 1100);
+    estimator.estimate(sample, 100, 2000, 500000, 10.0);
+    QCOMPARE(sample.blocksPerSecond, 10.0);
+    QCOMPARE(sample.transactionsPerSecond, 200.0);
+    QCOMPARE(sample.bytesPerSecond, 50000.0);
+    QCOMPARE(estimator.getSmoothedBlocksPerSecond(), 10.0);
+    QCOMPARE(sample.secondsRemaining, 100);
+
+    // A faster interval only moves the smoothed rate by a fifth of the difference: 10 + 0.2 * (30 - 10)
+    sample = makeSample(400, 1100);
+    estimator.estimate(sample, 300, 0, 0, 10.0);
+    QCOMPARE(sample.blocksPerSecond, 30.0);
+    QCOMPARE(estimator.getSmoothedBlocksPerSecond(), 14.0);
+    QCOMPARE(sample.secondsRemaining, 50);
+
+    // An interval without blocks slows the estimate down, but does not make it unknown
+    sample = makeSample(400, 1100);
+    estimator.estimate(sample, 0, 0, 0, 10.0);
+    QCOMPARE(sample.blocksPerSecond, 0.0);
+    QVERIFY(qAbs(estimator.getSmoothedBlocksPerSecond() - 11.2) < 1e-9);
+    QCOMPARE(sample.secondsRemaining, 62);
+
+    // A chain that got shorter counts as no progress
+    sample = makeSample(390, 1100);
+    estimator.estimate(sample, -10, 0, 0, 10.0);
+    QCOMPARE(sample.blocksPerSecond, 0.0);
+
+    // Caught up with the peers
+    sample = makeSample(1100, 1100);
+    estimator.estimate(sample, 700, 0, 0, 10.0);
+    QCOMPARE(sample.secondsRemaining, 0);
+    sample = makeSample(1200, 1100);
+    estimator.estimate(sample, 100, 0, 0, 10.0);
+    QCOMPARE(sample.secondsRemaining, 0);
+}
+
+void SyncTableModelTests::stalledTests()
+{
+    // Without any progress yet, the time remaining is unknown
+    SyncEstimator estimator;
+    SyncSample sample = makeSample(0, 1000);
+    estimator.estimate(sample, 0, 0, 0, 5.0);
+    QCOMPARE(estimator.getSmoothedBlocksPerSecond(), 0.0);
+    QCOMPARE(sample.secondsRemaining, -1);
+
+    // Progress after that is averaged with the stalled interval: 0 + 0.2 * 10
+    sample = makeSample(50, 1000);
+    estimator.estimate(sample, 50, 0, 0, 5.0);
+    QVERIFY(qAbs(estimator.getSmoothedBlocksPerSecond() - 2.0) < 1e-9);
+    QCOMPARE(sample.secondsRemaining, 475);
+}
@@ -0,0 +1,16 @@
+#ifndef SYNCTABLEMODELTESTS_H
+#define SYNCTABLEMODELTESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class SyncTableModelTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void estimatorTests();
+    void stalledTests();
+};
+
+#endif // SYNCTABLEMODELTESTS_H
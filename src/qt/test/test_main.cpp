@@ -1,11 +1,56 @@
-#include <QTest>
-#include <QObject>
-
-#include "urltests.h"
-
-// This is all you need to run all the tests
-int main(int argc, char *argv[])
-{
-    URLTests test1;
-    QTest::qExec(&test1);
-}
+#include <QTest>
+#include <QObject>
+
+#include "urltests.h"
+#include "bitcoinunitstests.h"
+#include "addresscheckertests.h"
+#include "addressbookfiletests.h"
+#include "guiutiltests.h"
+#include "messagesignertests.h"
+#include "walletbalancetests.h"
+#include "startupprofilertests.h"
+#include "batchclienttests.h"
+#include "synctablemodeltests.h"
+#include "addresstablemodeltests.h"
+
+// This is all you need to run all the tests
+int main(int argc, char *argv[])
+{
+    bool fInvalid = false;
+
+    URLTests test1;
+    if(QTest::qExec(&test1) != 0)
+        fInvalid = true;
+    BitcoinUnitsTests test2;
+    if(QTest::qExec(&test2) != 0)
+        fInvalid = true;
+    AddressCheckerTests test3;
+    if(QTest::qExec(&test3) != 0)
+        fInvalid = true;
+    AddressBookFileTests test4;
+    if(QTest::qExec(&test4) != 0)
+        fInvalid = true;
+    GUIUtilTests test5;
+    if(QTest::qExec(&test5) != 0)
+        fInvalid = true;
+    MessageSignerTests test6;
+    if(QTest::qExec(&test6) != 0)
+        fInvalid = true;
+    WalletBalanceTests test7;
+    if(QTest::qExec(&test7) != 0)
+        fInvalid = true;
+    StartupProfilerTests test8;
+    if(QTest::qExec(&test8) != 0)
+        fInvalid = true;
+    BatchClientTests test9;
+    if(QTest::qExec(&test9) != 0)
+        fInvalid = true;
+    SyncTableModelTests test10;
+    if(QTest::qExec(&test10) != 0)
+        fInvalid = true;
+    AddressTableModelTests test11;
+    if(QTest::qExec(&test11) != 0)
+        fInvalid = true;
+
+    return fInvalid;
+}
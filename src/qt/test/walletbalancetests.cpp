@@ -0,0 +1,59 @@
+#include "walletbalancetests.h"
+#include "../walletbalance.h"
+#include "../bench/syntheticwallet.h"
+
+// Totals kept up to date by update() must equal the totals of a full recompute
+static void compareWithRefresh(SyntheticWallet &wallet, const WalletBalance &incremental)
+{
+    WalletBalance full(&wallet);
+    full.refresh();
+    QCOMPARE(incremental.getConfirmed(), full.getConfirmed());
+    QCOMPARE(incremental.getUnconfirmed(), full.getUnconfirmed());
+    QCOMPARE(incremental.getImmature(), full.getImmature());
+    QCOMPARE(incremental.getBestHeight(), full.getBestHeight());
+}
+
+void WalletBalanceTests::incrementalTests()
+{
+    SyntheticWallet wallet(400, 50);
+    WalletBalance incremental(&wallet);
+    incremental.refresh();
+    compareWithRefresh(wallet, incremental);
+    QVERIFY(incremental.getImmature() != 0);
+
+    // New unconfirmed transactions
+    incremental.update(wallet.addTransactions(20));
+    compareWithRefresh(wallet, incremental);
+    QVERIFY(incremental.getUnconfirmed() != 0);
+
+    // A block with new transactions, then one that confirms the unconfirmed ones
+    incremental.update(wallet.addBlock(8));
+    compareWithRefresh(wallet, incremental);
+    incremental.update(wallet.confirmTransactions());
+    compareWithRefresh(wallet, incremental);
+    QCOMPARE(incremental.getUnconfirmed(), (qint64)0);
+
+    // Empty blocks only change the maturity of generated coins
+    for(int i = 0; i < 120; ++i)
+    {
+        wallet.addBlock(0);
+        incremental.update(QList<uint256>());
+        compareWithRefresh(wallet, incremental);
+    }
+
+    // A reorganization to a chain of the same height, and one to a longer chain
+    incremental.update(wallet.addBlock(10));
+    incremental.update(wallet.reorganize(3));
+    compareWithRefresh(wallet, incremental);
+    QList<uint256> changed = wallet.reorganize(2);
+    changed += wallet.confirmTransactions();
+    incremental.update(changed);
+    compareWithRefresh(wallet, incremental);
+
+    // Dropped transactions leave the totals
+    QList<uint256> added = wallet.addTransactions(5);
+    incremental.update(added);
+    wallet.removeTransaction(added.at(0));
+    incremental.update(added.mid(0, 1));
+    compareWithRefresh(wallet, incremental);
+}
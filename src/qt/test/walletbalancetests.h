@@ -0,0 +1,15 @@
+#ifndef WALLETBALANCETESTS_H
+#define WALLETBALANCETESTS_H
+
+#include <QTest>
+#include <QObject>
+
+class WalletBalanceTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void incrementalTests();
+};
+
+#endif // WALLETBALANCETESTS_H
@@ -2,21 +2,19 @@
 #include "guiutil.h"
 #include "transactionrecord.h"
 #include "guiconstants.h"
-#include "transactiondesc.h"
 #include "walletmodel.h"
 #include "optionsmodel.h"
 #include "addresstablemodel.h"
 #include "bitcoinunits.h"
-
-#include <coinWallet/Wallet.h>
+#include "walletinterface.h"
 
 #include <QLocale>
 #include <QList>
 #include <QColor>
-#include <QTimer>
 #include <QIcon>
 #include <QDateTime>
 #include <QtAlgorithms>
+#include <QTimer>
 
 // Amount column is right-aligned it contains numbers
 static int column_alignments[] = {
@@ -47,13 +45,18 @@ struct TxLessThan
 // Private implementation
 struct TransactionTablePriv
 {
-    TransactionTablePriv(Wallet *wallet, TransactionTableModel *parent):
+    TransactionTablePriv(WalletInterface *wallet, TransactionTableModel *parent):
             wallet(wallet),
-            parent(parent)
+            parent(parent),
+            populated(false)
     {
     }
-    Wallet *wallet;
+    WalletInterface *wallet;
     TransactionTableModel *parent;
+    /* Set once the cache was filled from the wallet. Updates before that are
+     * not needed, as filling reads the current state of the whole wallet.
+     */
+    bool populated;
 
     /* Local cache of wallet.
      * As it is in the same order as the Wallet, by definition
@@ -68,14 +71,8 @@ struct TransactionTablePriv
 #ifdef WALLET_UPDATE_DEBUG
         qDebug() << "refreshWallet";
 #endif
-        cachedWallet.clear();
-        CRITICAL_BLOCK(wallet->cs_wallet)
-        {
-            for(std::map<uint256, CWalletTx>::iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
-            {
-                cachedWallet.append(TransactionRecord::decomposeTransaction(wallet, it->second));
-            }
-        }
+        cachedWallet = wallet->getTransactionRecords();
+        populated = true;
     }
 
     /* Update our model of the wallet incrementally, to synchronize our model of the wallet
@@ -95,62 +92,57 @@ struct TransactionTablePriv
         QList<uint256> updated_sorted = updated;
         qSort(updated_sorted);
 
-        CRITICAL_BLOCK(wallet->cs_wallet)
+        for(int update_idx = updated_sorted.size()-1; update_idx >= 0; --update_idx)
         {
-            for(int update_idx = updated_sorted.size()-1; update_idx >= 0; --update_idx)
+            const uint256 &hash = updated_sorted.at(update_idx);
+            // Find transaction in wallet
+            bool inWallet = wallet->haveTransaction(hash);
+            // Find bounds of this transaction in model
+            QList<TransactionRecord>::iterator lower = qLowerBound(
+                cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
+            QList<TransactionRecord>::iterator upper = qUpperBound(
+                cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
+            int lowerIndex = (lower - cachedWallet.begin());
+            int upperIndex = (upper - cachedWallet.begin());
+
+            // Determine if transaction is in model already
+            bool inModel = false;
+            if(lower != upper)
             {
-                const uint256 &hash = updated_sorted.at(update_idx);
-                // Find transaction in wallet
-                std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(hash);
-                bool inWallet = mi != wallet->mapWallet.end();
-                // Find bounds of this transaction in model
-                QList<TransactionRecord>::iterator lower = qLowerBound(
-                    cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-                QList<TransactionRecord>::iterator upper = qUpperBound(
-                    cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-                int lowerIndex = (lower - cachedWallet.begin());
-                int upperIndex = (upper - cachedWallet.begin());
-
-                // Determine if transaction is in model already
-                bool inModel = false;
-                if(lower != upper)
-                {
-                    inModel = true;
-                }
+                inModel = true;
+            }
 
 #ifdef WALLET_UPDATE_DEBUG
-                qDebug() << "  " << QString::fromStdString(hash.ToString()) << inWallet << " " << inModel
-                        << lowerIndex << "-" << upperIndex;
+            qDebug() << "  " << QString::fromStdString(hash.ToString()) << inWallet << " " << inModel
+                    << lowerIndex << "-" << upperIndex;
 #endif
 
-                if(inWallet && !inModel)
+            if(inWallet && !inModel)
+            {
+                // Added -- insert at the right position
+                QList<TransactionRecord> toInsert = wallet->getTransactionRecords(hash);
+                if(!toInsert.isEmpty()) /* only if something to insert */
                 {
-                    // Added -- insert at the right position
-                    QList<TransactionRecord> toInsert =
-                            TransactionRecord::decomposeTransaction(wallet, mi->second);
-                    if(!toInsert.isEmpty()) /* only if something to insert */
+                    parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+toInsert.size()-1);
+                    int insert_idx = lowerIndex;
+                    foreach(const TransactionRecord &rec, toInsert)
                     {
-                        parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+toInsert.size()-1);
-                        int insert_idx = lowerIndex;
-                        foreach(const TransactionRecord &rec, toInsert)
-                        {
-                            cachedWallet.insert(insert_idx, rec);
-                            insert_idx += 1;
-                        }
-                        parent->endInsertRows();
+                        cachedWallet.insert(insert_idx, rec);
+                        insert_idx += 1;
                     }
+                    parent->endInsertRows();
                 }
-                else if(!inWallet && inModel)
-                {
-                    // Removed -- remove entire transaction from table
-                    parent->beginRemoveRows(QModelIndex(), lowerIndex, upperIndex-1);
-                    cachedWallet.erase(lower, upper);
-                    parent->endRemoveRows();
-                }
-                else if(inWallet && inModel)
-                {
-                    // Updated -- nothing to do, status update will take care of this
-                }
+            }
+            else if(!inWallet && inModel)
+            {
+                // Removed -- remove entire transaction from table
+                parent->beginRemoveRows(QModelIndex(), lowerIndex, upperIndex-1);
+                cachedWallet.erase(lower, upper);
+                parent->endRemoveRows();
+            }
+            else if(inWallet && inModel)
+            {
+                // Updated -- nothing to do, status update will take care of this
             }
         }
     }
@@ -171,15 +163,7 @@ struct TransactionTablePriv
             // simply re-use the cached status.
             if(rec->statusUpdateNeeded(wallet->getBestHeight()))
             {
-                CRITICAL_BLOCK(wallet->cs_wallet)
-                {
-                    std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(rec->hash);
-
-                    if(mi != wallet->mapWallet.end())
-                    {
-                        rec->updateStatus(mi->second);
-                    }
-                }
+                wallet->updateStatus(*rec);
             }
             return rec;
         }
@@ -191,20 +175,12 @@ struct TransactionTablePriv
 
     QString describe(TransactionRecord *rec)
     {
-        CRITICAL_BLOCK(wallet->cs_wallet)
-        {
-            std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(rec->hash);
-            if(mi != wallet->mapWallet.end())
-            {
-                return TransactionDesc::toHTML(wallet, mi->second);
-            }
-        }
-        return QString("");
+        return wallet->describeTransaction(*rec);
     }
 
 };
 
-TransactionTableModel::TransactionTableModel(Wallet* wallet, WalletModel *parent):
+TransactionTableModel::TransactionTableModel(WalletInterface *wallet, WalletModel *parent):
         QAbstractTableModel(parent),
         wallet(wallet),
         walletModel(parent),
@@ -212,11 +188,7 @@ TransactionTableModel::TransactionTableModel(Wallet* wallet, WalletModel *parent
 {
     columns << QString() << tr("Date") << tr("Type") << tr("Address") << tr("Amount");
 
-    priv->refreshWallet();
-
-    QTimer *timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), this, SLOT(update()));
-    timer->start(MODEL_UPDATE_DELAY);
+    QTimer::singleShot(0, this, SLOT(populate()));
 }
 
 TransactionTableModel::~TransactionTableModel()
@@ -224,24 +196,30 @@ TransactionTableModel::~TransactionTableModel()
     delete priv;
 }
 
-void TransactionTableModel::update()
+void TransactionTableModel::addMemoryUsage(MemoryUsage &usage, const QString &walletName) const
 {
-    QList<uint256> updated;
-
-    // Check if there are changes to wallet map
-    TRY_CRITICAL_BLOCK(wallet->cs_wallet)
+    qint64 bytes = 0;
+    foreach(const TransactionRecord &rec, priv->cachedWallet)
     {
-        if(!wallet->vWalletUpdated.empty())
-        {
-            BOOST_FOREACH(uint256 hash, wallet->vWalletUpdated)
-            {
-                updated.append(hash);
-            }
-            wallet->vWalletUpdated.clear();
-        }
+        // QList stores large items by pointer
+        bytes += sizeof(void*) + sizeof(TransactionRecord) + rec.address.capacity();
     }
+    usage.append(MemoryUsageEntry(tr("%1: transaction table").arg(walletName), priv->cachedWallet.size(), bytes));
+}
+
+void TransactionTableModel::populate()
+{
+    if(priv->populated)
+        return;
+    // Reset rather than insert, so that existing transactions are not announced as incoming
+    beginResetModel();
+    priv->refreshWallet();
+    endResetModel();
+}
 
-    if(!updated.empty())
+void TransactionTableModel::updateTransactions(const QList<uint256> &updated)
+{
+    if(priv->populated && !updated.empty())
     {
         priv->updateWallet(updated);
 
@@ -321,18 +299,33 @@ QString TransactionTableModel::formatTxDate(const TransactionRecord *wtx) const
     }
 }
 
+/* Label of address in the address book. Without a wallet model (benchmarks, load tests) it
+   comes straight from the wallet interface.
+ */
+QString TransactionTableModel::labelForAddress(const std::string &address) const
+{
+    if(walletModel)
+        return walletModel->getAddressTableModel()->labelForAddress(QString::fromStdString(address));
+    return wallet->labelForAddress(QString::fromStdString(address));
+}
+
+int TransactionTableModel::displayUnit() const
+{
+    return walletModel ? walletModel->getOptionsModel()->getDisplayUnit() : BitcoinUnits::BTC;
+}
+
 /* Look up address in address book, if found return label (address)
    otherwise just return (address)
  */
 QString TransactionTableModel::lookupAddress(const std::string &address, bool tooltip) const
 {
-    QString label = walletModel->getAddressTableModel()->labelForAddress(QString::fromStdString(address));
+    QString label = labelForAddress(address);
     QString description;
     if(!label.isEmpty())
     {
         description += label + QString(" ");
     }
-    if(label.isEmpty() || walletModel->getOptionsModel()->getDisplayAddresses() || tooltip)
+    if(label.isEmpty() || (walletModel && walletModel->getOptionsModel()->getDisplayAddresses()) || tooltip)
     {
         description += QString("(") + QString::fromStdString(address) + QString(")");
     }
@@ -403,7 +396,7 @@ QVariant TransactionTableModel::addressColor(const TransactionRecord *wtx) const
     case TransactionRecord::RecvWithAddress:
     case TransactionRecord::SendToAddress:
         {
-        QString label = walletModel->getAddressTableModel()->labelForAddress(QString::fromStdString(wtx->address));
+        QString label = labelForAddress(wtx->address);
         if(label.isEmpty())
             return COLOR_BAREADDRESS;
         } break;
@@ -418,15 +411,17 @@ QVariant TransactionTableModel::addressColor(const TransactionRecord *wtx) const
 
 QString TransactionTableModel::formatTxAmount(const TransactionRecord *wtx, bool showUnconfirmed) const
 {
-    QString str = BitcoinUnits::format(walletModel->getOptionsModel()->getDisplayUnit(), wtx->credit + wtx->debit);
-    if(showUnconfirmed)
-    {
-        if(!wtx->status.confirmed || wtx->status.maturity != TransactionStatus::Mature)
-        {
-            str = QString("[") + str + QString("]");
-        }
-    }
-    return QString(str);
+    // Called for every painted amount cell and every exported row, so build the string in one go
+    QChar buf[BitcoinUnits::MAX_FORMAT_LENGTH + 2];
+    bool brackets = showUnconfirmed &&
+            (!wtx->status.confirmed || wtx->status.maturity != TransactionStatus::Mature);
+    int len = 0;
+    if(brackets)
+        buf[len++] = '[';
+    len += BitcoinUnits::format(displayUnit(), wtx->credit + wtx->debit, false, buf + len);
+    if(brackets)
+        buf[len++] = ']';
+    return QString(buf, len);
 }
 
 QVariant TransactionTableModel::txStatusDecoration(const TransactionRecord *wtx) const
@@ -559,7 +554,7 @@ QVariant TransactionTableModel::data(const QModelIndex &index, int role) const
     case AddressRole:
         return QString::fromStdString(rec->address);
     case LabelRole:
-        return walletModel->getAddressTableModel()->labelForAddress(QString::fromStdString(rec->address));
+        return labelForAddress(rec->address);
     case AmountRole:
         return rec->credit + rec->debit;
     case TxIDRole:
@@ -4,7 +4,11 @@
 #include <QAbstractTableModel>
 #include <QStringList>
 
-class Wallet;
+#include <coin/uint256.h>
+
+#include "memoryusage.h"
+
+class WalletInterface;
 class TransactionTablePriv;
 class TransactionRecord;
 class WalletModel;
@@ -15,7 +19,8 @@ class TransactionTableModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
-    explicit TransactionTableModel(Wallet* wallet, WalletModel *parent = 0);
+    /** Without a wallet model, labels are read from the wallet interface and amounts shown in BTC. */
+    explicit TransactionTableModel(WalletInterface *wallet, WalletModel *parent = 0);
     ~TransactionTableModel();
 
     enum ColumnIndex {
@@ -55,12 +60,29 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const;
     QModelIndex index(int row, int column, const QModelIndex & parent = QModelIndex()) const;
+
+    /** Synchronize the model with the given list of added, removed or changed transactions.
+        Called by the wallet model, which collects the updates from the core.
+    */
+    void updateTransactions(const QList<uint256> &updated);
+
+    /** Add the estimated memory used by the cached transaction records. */
+    void addMemoryUsage(MemoryUsage &usage, const QString &walletName) const;
+
+public slots:
+    /** Fill the model from the wallet. The constructor defers this to the event loop, so that
+        creating the model does not hold up showing the window; calling it earlier is harmless.
+    */
+    void populate();
+
 private:
-    Wallet* wallet;
+    WalletInterface *wallet;
     WalletModel *walletModel;
     QStringList columns;
     TransactionTablePriv *priv;
 
+    QString labelForAddress(const std::string &address) const;
+    int displayUnit() const;
     QString lookupAddress(const std::string &address, bool tooltip) const;
     QVariant addressColor(const TransactionRecord *wtx) const;
     QString formatTxStatus(const TransactionRecord *wtx) const;
@@ -72,9 +94,6 @@ private:
     QVariant txStatusDecoration(const TransactionRecord *wtx) const;
     QVariant txAddressDecoration(const TransactionRecord *wtx) const;
 
-private slots:
-    void update();
-
     friend class TransactionTablePriv;
 };
 
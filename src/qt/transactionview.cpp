@@ -154,10 +154,19 @@ TransactionView::TransactionView(QWidget *parent) :
 void TransactionView::setModel(WalletModel *model)
 {
     this->model = model;
-    if(model)
+    setTransactionModel(model ? model->getTransactionTableModel() : 0);
+}
+
+void TransactionView::setTransactionModel(QAbstractItemModel *transactionModel)
+{
+    // Switching wallets, the proxy of the previous wallet is no longer needed
+    delete transactionProxyModel;
+    transactionProxyModel = 0;
+
+    if(transactionModel)
     {
         transactionProxyModel = new TransactionFilterProxy(this);
-        transactionProxyModel->setSourceModel(model->getTransactionTableModel());
+        transactionProxyModel->setSourceModel(transactionModel);
         transactionProxyModel->setDynamicSortFilter(true);
 
         transactionProxyModel->setSortRole(Qt::EditRole);
@@ -337,11 +346,8 @@ void TransactionView::editLabel()
         if(idx != -1)
         {
             // Edit sending / receiving address
-            QModelIndex modelIdx = addressBook->index(idx, 0, QModelIndex());
             // Determine type of address, launch appropriate editor dialog type
-            QString type = modelIdx.data(AddressTableModel::TypeRole).toString();
-
-            EditAddressDialog dlg(type==AddressTableModel::Receive
+            EditAddressDialog dlg(addressBook->isReceiving(idx)
                                          ? EditAddressDialog::EditReceivingAddress
                                          : EditAddressDialog::EditSendingAddress,
                                   this);
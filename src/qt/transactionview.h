@@ -7,6 +7,7 @@ class WalletModel;
 class TransactionFilterProxy;
 
 QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
 class QTableView;
 class QComboBox;
 class QLineEdit;
@@ -26,6 +27,10 @@ public:
     explicit TransactionView(QWidget *parent = 0);
 
     void setModel(WalletModel *model);
+    /** Show a model with the columns and roles of TransactionTableModel. setModel does this for the
+        wallet's table model, the UI benchmarks use it without a wallet model.
+     */
+    void setTransactionModel(QAbstractItemModel *transactionModel);
 
     // Date ranges for filter
     enum DateEnum
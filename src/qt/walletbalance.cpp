@@ -0,0 +1,78 @@
+#include "walletbalance.h"
+
+#include <boost/foreach.hpp>
+
+WalletBalance::WalletBalance(BalanceSource *source):
+    source(source), nConfirmed(0), nUnconfirmed(0), nImmature(0), nBestHeight(-1), hashBestBlock(0)
+{
+}
+
+void WalletBalance::apply(const uint256 &hash)
+{
+    std::map<uint256, TxBalance>::iterator old = mapTxBalance.find(hash);
+    if(old != mapTxBalance.end())
+    {
+        nConfirmed -= old->second.confirmed;
+        nUnconfirmed -= old->second.unconfirmed;
+        nImmature -= old->second.immature;
+        mapTxBalance.erase(old);
+    }
+    setPending.erase(hash);
+
+    TxBalance bal;
+    if(!source->getTxBalance(hash, bal))
+        return;
+    nConfirmed += bal.confirmed;
+    nUnconfirmed += bal.unconfirmed;
+    nImmature += bal.immature;
+    mapTxBalance.insert(std::make_pair(hash, bal));
+    if(bal.pending)
+        setPending.insert(hash);
+}
+
+void WalletBalance::refresh()
+{
+    mapTxBalance.clear();
+    setPending.clear();
+    nConfirmed = nUnconfirmed = nImmature = 0;
+    source->getBestBlock(nBestHeight, hashBestBlock);
+    BOOST_FOREACH(const uint256 &hash, source->getTransactions())
+    {
+        apply(hash);
+    }
+}
+
+void WalletBalance::update(const QList<uint256> &updated)
+{
+    int nHeight;
+    uint256 hashTip;
+    source->getBestBlock(nHeight, hashTip);
+    if(hashTip != hashBestBlock)
+    {
+        // Only blocks on top of the previous tip leave the settled transactions alone. A
+        // reorganization can replace blocks at any height, even without lowering the tip,
+        // and then confirmations can have moved anywhere.
+        if(nHeight < nBestHeight || !source->isInBestChain(nBestHeight, hashBestBlock))
+        {
+            refresh();
+            return;
+        }
+        nBestHeight = nHeight;
+        hashBestBlock = hashTip;
+        std::set<uint256> pending = setPending;
+        BOOST_FOREACH(const uint256 &hash, pending)
+        {
+            apply(hash);
+        }
+    }
+    foreach(const uint256 &hash, updated)
+    {
+        apply(hash);
+
+        // Outputs spent by this transaction are no longer available
+        BOOST_FOREACH(const uint256 &spent, source->getSpentTransactions(hash))
+        {
+            apply(spent);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef WALLETBALANCE_H
+#define WALLETBALANCE_H
+
+#include <QList>
+
+#include <coin/uint256.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+/** Contribution of a single wallet transaction to the balance totals */
+struct TxBalance
+{
+    TxBalance(): confirmed(0), unconfirmed(0), immature(0), pending(false) {}
+
+    qint64 confirmed;
+    qint64 unconfirmed;
+    qint64 immature;
+    /** Contribution can still change when new blocks arrive */
+    bool pending;
+};
+
+/** What WalletBalance needs to know of a wallet and the chain it follows.
+    Calls are made with the wallet locked, where the wallet has a lock.
+ */
+class BalanceSource
+{
+public:
+    virtual ~BalanceSource() {}
+
+    /** Hashes of all wallet transactions */
+    virtual std::vector<uint256> getTransactions() = 0;
+    /** Contribution of a transaction to the totals. Returns false if it is not in the wallet. */
+    virtual bool getTxBalance(const uint256 &hash, TxBalance &balance) = 0;
+    /** Wallet transactions whose outputs are spent by a transaction */
+    virtual std::vector<uint256> getSpentTransactions(const uint256 &hash) = 0;
+    /** Height and hash of the best block, -1 and 0 without blocks */
+    virtual void getBestBlock(int &height, uint256 &hash) = 0;
+    /** Whether the block with hash at height is in the chain leading to the best block */
+    virtual bool isInBestChain(int height, const uint256 &hash) = 0;
+};
+
+/** Running balance totals of a wallet, kept up to date from the transactions the wallet reports
+    as changed, instead of walking the entire wallet on every update.
+
+    Only transactions whose contribution depends on the height (unconfirmed, non-final and
+    immature generated transactions) are re-evaluated when blocks arrive on top of the tip.
+    Any other change of the tip is a reorganization, and rebuilds the totals.
+ */
+class WalletBalance
+{
+public:
+    explicit WalletBalance(BalanceSource *source);
+
+    /** Rebuild the totals from the entire wallet */
+    void refresh();
+    /** Fold in the transactions that were added or changed, and re-evaluate the pending
+        transactions if blocks came in.
+     */
+    void update(const QList<uint256> &updated);
+
+    qint64 getConfirmed() const { return nConfirmed; }
+    qint64 getUnconfirmed() const { return nUnconfirmed; }
+    qint64 getImmature() const { return nImmature; }
+    int getBestHeight() const { return nBestHeight; }
+
+private:
+    BalanceSource *source;
+
+    /* Per transaction contributions, the totals below are their sum */
+    std::map<uint256, TxBalance> mapTxBalance;
+    /* Transactions whose contribution depends on the chain height */
+    std::set<uint256> setPending;
+
+    qint64 nConfirmed;
+    qint64 nUnconfirmed;
+    qint64 nImmature;
+    int nBestHeight;
+    /* Tip the totals were computed for, to tell a chain that grew from a reorganization */
+    uint256 hashBestBlock;
+
+    /** Recompute the contribution of one transaction */
+    void apply(const uint256 &hash);
+};
+
+#endif // WALLETBALANCE_H
@@ -0,0 +1,207 @@
+#include "walletinterface.h"
+#include "transactiondesc.h"
+#include "deterministickeychain.h"
+#include "keypoolrefiller.h"
+
+#include <coin/Address.h>
+#include <coinWallet/Wallet.h>
+#include <coinWallet/WalletDB.h>
+
+CoreWalletInterface::CoreWalletInterface(Wallet *wallet):
+    wallet(wallet), keyChain(DeterministicKeyChain::load(wallet)), refiller(0)
+{
+}
+
+CoreWalletInterface::~CoreWalletInterface()
+{
+    delete keyChain;
+}
+
+QList<TransactionRecord> CoreWalletInterface::getTransactionRecords()
+{
+    QList<TransactionRecord> records;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        for(std::map<uint256, CWalletTx>::iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
+        {
+            records.append(TransactionRecord::decomposeTransaction(wallet, it->second));
+        }
+    }
+    return records;
+}
+
+bool CoreWalletInterface::haveTransaction(const uint256 &hash)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+        return wallet->mapWallet.count(hash) != 0;
+    return false;
+}
+
+QList<TransactionRecord> CoreWalletInterface::getTransactionRecords(const uint256 &hash)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(hash);
+        if(mi != wallet->mapWallet.end())
+            return TransactionRecord::decomposeTransaction(wallet, mi->second);
+    }
+    return QList<TransactionRecord>();
+}
+
+void CoreWalletInterface::updateStatus(TransactionRecord &rec)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(rec.hash);
+        if(mi != wallet->mapWallet.end())
+            rec.updateStatus(mi->second);
+    }
+}
+
+QString CoreWalletInterface::describeTransaction(const TransactionRecord &rec)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(rec.hash);
+        if(mi != wallet->mapWallet.end())
+            return TransactionDesc::toHTML(wallet, mi->second);
+    }
+    return QString();
+}
+
+int CoreWalletInterface::getBestHeight()
+{
+    return wallet->getBestHeight();
+}
+
+QList<WalletInterface::AddressBookEntry> CoreWalletInterface::getAddressBook()
+{
+    QList<AddressBookEntry> entries;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        for(std::map<ChainAddress, std::string>::const_iterator item = wallet->mapAddressBook.begin(); item != wallet->mapAddressBook.end(); ++item)
+        {
+            const ChainAddress& address = item->first;
+            entries.append(AddressBookEntry(QString::fromStdString(address.toString()),
+                                            QString::fromStdString(item->second),
+                                            wallet->haveKey(address.getPubKeyHash())));
+        }
+    }
+    return entries;
+}
+
+bool CoreWalletInterface::haveAddressBookEntry(const QString &address)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+        return wallet->mapAddressBook.count(ChainAddress(address.toStdString())) != 0;
+    return false;
+}
+
+bool CoreWalletInterface::isMine(const QString &address)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+        return wallet->haveKey(ChainAddress(address.toStdString()).getPubKeyHash());
+    return false;
+}
+
+QString CoreWalletInterface::labelForAddress(const QString &address)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        std::map<ChainAddress, std::string>::iterator mi = wallet->mapAddressBook.find(ChainAddress(address.toStdString()));
+        if(mi != wallet->mapAddressBook.end())
+            return QString::fromStdString(mi->second);
+    }
+    return QString();
+}
+
+void CoreWalletInterface::setAddressBookName(const QString &address, const QString &label)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+        wallet->SetAddressBookName(address.toStdString(), label.toStdString());
+}
+
+bool CoreWalletInterface::setAddressBookNames(const QList<AddressBookEntry> &entries)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        // SetAddressBookName opens and commits a write per call, which dominates large imports
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(!walletdb.TxnBegin())
+            return false;
+        foreach(const AddressBookEntry &entry, entries)
+        {
+            if(!walletdb.WriteName(entry.address.toStdString(), entry.label.toStdString()))
+            {
+                walletdb.TxnAbort();
+                return false;
+            }
+        }
+        if(!walletdb.TxnCommit())
+            return false;
+        // Only touch the in-memory book once the entries are on disk
+        foreach(const AddressBookEntry &entry, entries)
+            wallet->mapAddressBook[ChainAddress(entry.address.toStdString())] = entry.label.toStdString();
+    }
+    return true;
+}
+
+void CoreWalletInterface::delAddressBookName(const QString &address)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+        wallet->DelAddressBookName(address.toStdString());
+}
+
+void CoreWalletInterface::changeAddress(const QString &oldAddress, const QString &newAddress, const QString &label)
+{
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        wallet->DelAddressBookName(oldAddress.toStdString());
+        wallet->SetAddressBookName(newAddress.toStdString(), label.toStdString());
+    }
+}
+
+void CoreWalletInterface::setKeyPoolRefiller(KeyPoolRefiller *refiller)
+{
+    this->refiller = refiller;
+}
+
+bool CoreWalletInterface::takeKeyFromPool(std::vector<unsigned char> &pubKey)
+{
+    // ReserveKeyFromKeyPool and GetKeyFromPool top up the pool first, which generates keys on the
+    // calling thread. Take the oldest key the same way they do, but leave refilling to the refiller.
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        if(wallet->setKeyPool.empty())
+            return false;
+        int64 nIndex = *wallet->setKeyPool.begin();
+        CKeyPool keypool;
+        CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+        if(!walletdb.ReadPool(nIndex, keypool) || !wallet->haveKey(toPubKeyHash(keypool.vchPubKey)))
+            return false;
+        // Once it is erased from the file the key is ours, even if the wallet is reloaded
+        if(!walletdb.ErasePool(nIndex))
+            return false;
+        wallet->setKeyPool.erase(nIndex);
+        pubKey = keypool.vchPubKey;
+        return true;
+    }
+    return false;
+}
+
+bool CoreWalletInterface::getNewAddress(QString &address)
+{
+    std::vector<unsigned char> newKey;
+    // Derive the key from the wallet seed if there is one, otherwise take one from the pool
+    if(keyChain && !keyChain->getNewKey(newKey))
+        newKey.clear();
+    bool fFromPool = newKey.empty();
+    bool fTaken = !fFromPool || takeKeyFromPool(newKey);
+    // An empty pool is refilled by the refiller, which is asked to do so right away
+    if(fFromPool && refiller)
+        refiller->wake();
+    if(!fTaken)
+        return false;
+    address = QString::fromStdString(wallet->chain().getAddress(toPubKeyHash(newKey)).toString());
+    return true;
+}
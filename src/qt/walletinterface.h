@@ -0,0 +1,111 @@
+#ifndef WALLETINTERFACE_H
+#define WALLETINTERFACE_H
+
+#include <QString>
+#include <QList>
+#include <QPointer>
+
+#include "transactionrecord.h"
+
+class Wallet;
+class DeterministicKeyChain;
+class KeyPoolRefiller;
+
+/** Wallet as seen by the table models. The models only depend on this interface, so that they can
+    run against the core wallet (CoreWalletInterface) or against a synthetic in-memory wallet in
+    benchmarks and load tests. Implementations do their own locking, every call is atomic.
+ */
+class WalletInterface
+{
+public:
+    virtual ~WalletInterface() {}
+
+    /** @name Transactions
+        @{*/
+    /** Records of all transactions that are shown, ordered by transaction hash */
+    virtual QList<TransactionRecord> getTransactionRecords() = 0;
+    /** Whether the transaction is in the wallet */
+    virtual bool haveTransaction(const uint256 &hash) = 0;
+    /** Records of a single transaction, empty if it is not in the wallet or not shown */
+    virtual QList<TransactionRecord> getTransactionRecords(const uint256 &hash) = 0;
+    /** Update the status of a record from its transaction, if that is still in the wallet */
+    virtual void updateStatus(TransactionRecord &rec) = 0;
+    /** Extended HTML description of the transaction of a record */
+    virtual QString describeTransaction(const TransactionRecord &rec) = 0;
+    /** Height of the best block, to know when record statuses are outdated */
+    virtual int getBestHeight() = 0;
+    /**@}*/
+
+    /** @name Address book
+        @{*/
+    struct AddressBookEntry
+    {
+        AddressBookEntry(): mine(false) {}
+        AddressBookEntry(const QString &address, const QString &label, bool mine):
+            address(address), label(label), mine(mine) {}
+        QString address;
+        QString label;
+        /** Receiving address, we have the key */
+        bool mine;
+    };
+    virtual QList<AddressBookEntry> getAddressBook() = 0;
+    virtual bool haveAddressBookEntry(const QString &address) = 0;
+    /** Whether we have the key of an address, in the address book or not */
+    virtual bool isMine(const QString &address) = 0;
+    /** Label of an address, empty if it is not in the address book */
+    virtual QString labelForAddress(const QString &address) = 0;
+    virtual void setAddressBookName(const QString &address, const QString &label) = 0;
+    /** Add or relabel many entries at once, written to the wallet file in a single transaction.
+        Returns false if the transaction failed, in which case nothing was written.
+     */
+    virtual bool setAddressBookNames(const QList<AddressBookEntry> &entries) = 0;
+    virtual void delAddressBookName(const QString &address) = 0;
+    /** Replace the address of an address book entry, keeping its label */
+    virtual void changeAddress(const QString &oldAddress, const QString &newAddress, const QString &label) = 0;
+    /** Take a key from the key pool and return its address, false if the pool is empty */
+    virtual bool getNewAddress(QString &address) = 0;
+    /**@}*/
+};
+
+/** WalletInterface on top of a core wallet.
+ */
+class CoreWalletInterface : public WalletInterface
+{
+public:
+    explicit CoreWalletInterface(Wallet *wallet);
+    ~CoreWalletInterface();
+
+    QList<TransactionRecord> getTransactionRecords();
+    bool haveTransaction(const uint256 &hash);
+    QList<TransactionRecord> getTransactionRecords(const uint256 &hash);
+    void updateStatus(TransactionRecord &rec);
+    QString describeTransaction(const TransactionRecord &rec);
+    int getBestHeight();
+
+    QList<AddressBookEntry> getAddressBook();
+    bool haveAddressBookEntry(const QString &address);
+    bool isMine(const QString &address);
+    QString labelForAddress(const QString &address);
+    void setAddressBookName(const QString &address, const QString &label);
+    bool setAddressBookNames(const QList<AddressBookEntry> &entries);
+    void delAddressBookName(const QString &address);
+    void changeAddress(const QString &oldAddress, const QString &newAddress, const QString &label);
+    bool getNewAddress(QString &address);
+
+    /** Refiller to wake when a key was taken from the pool. Keys are never generated on the calling
+        thread, without a refiller an empty pool stays empty.
+     */
+    void setKeyPoolRefiller(KeyPoolRefiller *refiller);
+
+private:
+    Wallet *wallet;
+    // New receiving keys are derived from the wallet seed if it has one, 0 otherwise
+    DeterministicKeyChain *keyChain;
+    // Cleared when the refillers are stopped before the wallet is closed
+    QPointer<KeyPoolRefiller> refiller;
+
+    /** Take the oldest key from the pool, without topping the pool up */
+    bool takeKeyFromPool(std::vector<unsigned char> &pubKey);
+};
+
+#endif // WALLETINTERFACE_H
@@ -0,0 +1,210 @@
+#include "walletmanager.h"
+#include "walletmodel.h"
+#include "walletrescanner.h"
+#include "keypoolrefiller.h"
+#include "deterministickeychain.h"
+
+#include <coinChain/Node.h>
+#include <coinWallet/Wallet.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+
+WalletManager::WalletManager(Node &node, const std::string &dataDir, OptionsModel *optionsModel, QObject *parent) :
+    QObject(parent), node(node), dataDir(dataDir), optionsModel(optionsModel), rescanner(0),
+    keyPoolSize(KeyPoolRefiller::DEFAULT_TARGET_SIZE), fDeterministic(false)
+{
+}
+
+WalletManager::~WalletManager()
+{
+    stopRescan();
+    stopKeyPoolRefill();
+    // Models refer to their wallet, so they go first
+    qDeleteAll(models);
+    models.clear();
+    qDeleteAll(ownedWallets);
+    ownedWallets.clear();
+    // Wallets constructed by the node thread that were not picked up any more
+    QMutexLocker lock(&constructedMutex);
+    foreach(const ConstructedWallet &constructed, constructedWallets)
+        delete constructed.wallet;
+    constructedWallets.clear();
+}
+
+void WalletManager::addWallet(const QString &name, Wallet *wallet)
+{
+    if(names.contains(name))
+        return;
+    names.append(name);
+    wallets.insert(name, wallet);
+    WalletModel *model = new WalletModel(wallet, node.blockChain(), optionsModel);
+    models.insert(name, model);
+    startKeyPoolRefill(name, wallet, model);
+}
+
+void WalletManager::registerWallet(const QString &name)
+{
+    if(names.contains(name))
+        return;
+    names.append(name);
+}
+
+bool WalletManager::isLoaded(const QString &name) const
+{
+    return models.contains(name);
+}
+
+WalletModel *WalletManager::getWalletModel(const QString &name) const
+{
+    return models.value(name);
+}
+
+void WalletManager::loadWallet(const QString &name)
+{
+    if(!names.contains(name) || loading.contains(name))
+        return;
+    WalletModel *model = models.value(name);
+    if(model)
+    {
+        emit walletLoaded(name, model);
+        return;
+    }
+    // Loading the wallet file also registers the wallet callbacks with the node, so do it on the node
+    // thread, where it cannot interleave with the node calling the callbacks of the other wallets
+    loading.insert(name);
+    node.get_io_service().post(boost::bind(&WalletManager::constructWallet, this, name));
+}
+
+void WalletManager::constructWallet(const QString &name)
+{
+    ConstructedWallet constructed;
+    constructed.wallet = 0;
+    constructed.fNew = !boost::filesystem::exists(dataDir + "/" + name.toStdString());
+    try
+    {
+        constructed.wallet = new Wallet(node, name.toStdString());
+    }
+    catch(std::exception &e)
+    {
+        constructed.error = QString::fromStdString(e.what());
+    }
+    {
+        QMutexLocker lock(&constructedMutex);
+        constructedWallets.insert(name, constructed);
+    }
+    QMetaObject::invokeMethod(this, "walletConstructed", Qt::QueuedConnection, Q_ARG(QString, name));
+}
+
+void WalletManager::walletConstructed(const QString &name)
+{
+    ConstructedWallet constructed;
+    {
+        QMutexLocker lock(&constructedMutex);
+        constructed = constructedWallets.take(name);
+    }
+    loading.remove(name);
+
+    Wallet *wallet = constructed.wallet;
+    if(!wallet)
+    {
+        emit error(tr("Wallet"), tr("Could not load wallet %1: %2").arg(name).arg(constructed.error));
+        return;
+    }
+    ownedWallets.append(wallet);
+    wallets.insert(name, wallet);
+    try
+    {
+        if(constructed.fNew)
+        {
+            WalletRescanner::setBirthday(wallet, QDateTime::currentDateTime().toTime_t());
+            if(fDeterministic)
+                DeterministicKeyChain::init(wallet);
+        }
+    }
+    catch(std::exception &e)
+    {
+        emit error(tr("Wallet"), tr("Could not set up wallet %1: %2").arg(name).arg(QString::fromStdString(e.what())));
+    }
+
+    WalletModel *model = new WalletModel(wallet, node.blockChain(), optionsModel);
+    models.insert(name, model);
+    startKeyPoolRefill(name, wallet, model);
+    emit walletLoaded(name, model);
+}
+
+void WalletManager::addMemoryUsage(MemoryUsage &usage)
+{
+    foreach(const QString &name, names)
+    {
+        WalletModel *model = models.value(name);
+        if(model)
+            model->addMemoryUsage(usage, name);
+    }
+}
+
+WalletRescanner *WalletManager::rescan(const QString &name, int startHeight)
+{
+    Wallet *wallet = wallets.value(name);
+    if(!wallet || rescanner)
+        return 0;
+    rescanner = new WalletRescanner(node, wallet, startHeight);
+    connect(rescanner, SIGNAL(finished()), this, SLOT(rescanDone()));
+    rescanner->start(QThread::LowPriority);
+    return rescanner;
+}
+
+void WalletManager::stopRescan()
+{
+    // The destructor cancels the scan and waits for the thread
+    delete rescanner;
+    rescanner = 0;
+}
+
+void WalletManager::rescanDone()
+{
+    if(rescanner == sender())
+    {
+        rescanner->deleteLater();
+        rescanner = 0;
+    }
+}
+
+void WalletManager::setKeyPoolSize(int size)
+{
+    keyPoolSize = size;
+    foreach(KeyPoolRefiller *refiller, refillers)
+        refiller->setTargetSize(size);
+}
+
+void WalletManager::stopKeyPoolRefill()
+{
+    // The destructors stop the refillers and wait for their threads
+    qDeleteAll(refillers);
+    refillers.clear();
+}
+
+void WalletManager::startKeyPoolRefill(const QString &name, Wallet *wallet, WalletModel *model)
+{
+    KeyPoolRefiller *refiller = new KeyPoolRefiller(wallet, keyPoolSize);
+    // Keys can only be added to an encrypted wallet while it is unlocked
+    connect(model, SIGNAL(encryptionStatusChanged(int)), refiller, SLOT(wake()));
+    // Receiving addresses only take keys from the pool, the refiller replaces them
+    model->setKeyPoolRefiller(refiller);
+    refiller->start(QThread::LowestPriority);
+    refillers.insert(name, refiller);
+}
+
+QDateTime WalletManager::getBirthday(const QString &name) const
+{
+    Wallet *wallet = wallets.value(name);
+    qint64 nBirthday = wallet ? WalletRescanner::getBirthday(wallet) : 0;
+    if(!nBirthday)
+        return QDateTime();
+    return QDateTime::fromTime_t(nBirthday);
+}
+
+int WalletManager::heightForDate(const QDateTime &date) const
+{
+    return WalletRescanner::heightForTime(node, date.toTime_t());
+}
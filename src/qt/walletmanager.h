@@ -0,0 +1,119 @@
+#ifndef WALLETMANAGER_H
+#define WALLETMANAGER_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QStringList>
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+
+#include "memoryusage.h"
+
+#include <string>
+
+class OptionsModel;
+class WalletModel;
+class WalletRescanner;
+class KeyPoolRefiller;
+class Wallet;
+class Node;
+
+/** Keeps track of the wallets attached to the node in this process, and the models
+    for them. Wallets other than the default wallet are only loaded from disk the first
+    time they are asked for with loadWallet(), so that all of them share the single Node
+    (and its block chain) of the process.
+ */
+class WalletManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WalletManager(Node &node, const std::string &dataDir, OptionsModel *optionsModel, QObject *parent = 0);
+    ~WalletManager();
+
+    /** Add an already loaded wallet. Ownership of the wallet stays with the caller. */
+    void addWallet(const QString &name, Wallet *wallet);
+    /** Register a wallet file in the data directory, to be loaded on first use. */
+    void registerWallet(const QString &name);
+
+    /** Names of all known wallets, in the order they were added. */
+    QStringList walletNames() const { return names; }
+    bool isLoaded(const QString &name) const;
+
+    /** Return the model for a loaded wallet, 0 if the wallet is unknown or not loaded yet. */
+    WalletModel *getWalletModel(const QString &name) const;
+    /** Load a registered wallet in the background, walletLoaded() is emitted when it is ready, or
+        right away if it is loaded already. The wallet is constructed on the node thread, so this is
+        only done while the node runs, and the manager must outlive the node thread.
+     */
+    void loadWallet(const QString &name);
+
+    /** Add the estimated memory used by all loaded wallets. */
+    void addMemoryUsage(MemoryUsage &usage);
+
+    /** Start rescanning the block chain for a loaded wallet from startHeight, or from its birthday if
+        startHeight is negative. Only one rescan runs at a time, returns 0 if another one is still running.
+     */
+    WalletRescanner *rescan(const QString &name, int startHeight = -1);
+    /** Cancel the running rescan, if any, and wait for it to stop. */
+    void stopRescan();
+
+    /** Number of keys to keep in the key pool of every loaded wallet. The pools are refilled
+        in the background, starting with the wallets loaded after this call.
+     */
+    void setKeyPoolSize(int size);
+    /** Stop refilling the key pools, and wait for the batches being written. */
+    void stopKeyPoolRefill();
+    /** Derive the receiving keys of wallets created from now on from a seed, see DeterministicKeyChain */
+    void setDeterministic(bool deterministic) { fDeterministic = deterministic; }
+
+    /** Wallet birthday of a loaded wallet, invalid if unknown. */
+    QDateTime getBirthday(const QString &name) const;
+    /** First block height to scan for transactions made at or after date. */
+    int heightForDate(const QDateTime &date) const;
+
+private:
+    Node &node;
+    std::string dataDir;
+    OptionsModel *optionsModel;
+
+    QStringList names;
+    QMap<QString, WalletModel*> models;
+    QMap<QString, Wallet*> wallets;
+    // Wallets loaded by the manager itself, deleted together with it
+    QList<Wallet*> ownedWallets;
+    WalletRescanner *rescanner;
+    int keyPoolSize;
+    QMap<QString, KeyPoolRefiller*> refillers;
+    bool fDeterministic;
+
+    // Wallets being loaded, and the results of the node thread for them
+    struct ConstructedWallet
+    {
+        Wallet *wallet;
+        bool fNew;
+        QString error;
+    };
+    QSet<QString> loading;
+    QMutex constructedMutex;
+    QMap<QString, ConstructedWallet> constructedWallets;
+
+    /** Load a wallet file, called on the node thread */
+    void constructWallet(const QString &name);
+    /** Start refilling the key pool of a wallet that was just added or loaded */
+    void startKeyPoolRefill(const QString &name, Wallet *wallet, WalletModel *model);
+
+signals:
+    /** A registered wallet was loaded and attached to the node */
+    void walletLoaded(const QString &name, WalletModel *model);
+
+    //! Asynchronous error notification
+    void error(const QString &title, const QString &message);
+
+private slots:
+    void rescanDone();
+    /** Pick up a wallet constructed by the node thread */
+    void walletConstructed(const QString &name);
+};
+
+#endif // WALLETMANAGER_H
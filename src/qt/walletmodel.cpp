@@ -3,74 +3,240 @@
 #include "optionsmodel.h"
 #include "addresstablemodel.h"
 #include "transactiontablemodel.h"
+#include "walletinterface.h"
+#include "deterministickeychain.h"
+#include "addresschecker.h"
+#include "walletbalance.h"
 
 #include <QTimer>
 #include <QSet>
 
+#include <coinChain/Node.h>
 #include <coinWallet/Wallet.h>
 #include <coinWallet/WalletDB.h>
 
-WalletModel::WalletModel(Wallet *wallet, OptionsModel *optionsModel, QObject *parent) :
-    QObject(parent), wallet(wallet), optionsModel(optionsModel), addressTableModel(0),
-    transactionTableModel(0),
+#include <boost/foreach.hpp>
+
+#include <map>
+#include <set>
+
+// Balance source of a core wallet, and the totals computed from it
+struct WalletBalancePriv : public BalanceSource
+{
+    WalletBalancePriv(Wallet *wallet, const BlockChain &blockChain):
+            wallet(wallet), blockChain(blockChain), totals(this)
+    {
+    }
+    Wallet *wallet;
+    const BlockChain &blockChain;
+    WalletBalance totals;
+
+    std::vector<uint256> getTransactions()
+    {
+        std::vector<uint256> hashes;
+        hashes.reserve(wallet->mapWallet.size());
+        for(std::map<uint256, CWalletTx>::const_iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
+            hashes.push_back(it->first);
+        return hashes;
+    }
+
+    /* Classify a wallet transaction the same way Wallet::GetBalance and GetUnconfirmedBalance do:
+       non-final and unconfirmed transactions count as unconfirmed.
+     */
+    bool getTxBalance(const uint256 &hash, TxBalance &bal)
+    {
+        std::map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(hash);
+        if(mi == wallet->mapWallet.end())
+            return false;
+        const CWalletTx &wtx = mi->second;
+        if(wtx.isCoinBase() && wallet->GetBlocksToMaturity(wtx) > 0)
+        {
+            // Not yet spendable, orphaned blocks do not count at all
+            if(wallet->isInMainChain(wtx.getHash()))
+            {
+                BOOST_FOREACH(const Output& txout, wtx.getOutputs())
+                {
+                    if(wallet->IsMine(txout))
+                        bal.immature += txout.value();
+                }
+            }
+            bal.pending = true;
+            return true;
+        }
+        if(wallet->isFinal(wtx) && wallet->IsConfirmed(wtx))
+        {
+            bal.confirmed = wtx.GetAvailableCredit();
+        }
+        else
+        {
+            bal.unconfirmed = wtx.GetAvailableCredit();
+            bal.pending = true;
+        }
+        return true;
+    }
+
+    std::vector<uint256> getSpentTransactions(const uint256 &hash)
+    {
+        std::vector<uint256> spent;
+        std::map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(hash);
+        if(mi == wallet->mapWallet.end())
+            return spent;
+        BOOST_FOREACH(const Input& txin, mi->second.getInputs())
+        {
+            if(wallet->mapWallet.count(txin.prevout().hash))
+                spent.push_back(txin.prevout().hash);
+        }
+        return spent;
+    }
+
+    void getBestBlock(int &height, uint256 &hash)
+    {
+        const CBlockIndex *pindexBest = blockChain.getBestIndex();
+        height = pindexBest ? pindexBest->nHeight : -1;
+        hash = pindexBest ? pindexBest->GetBlockHash() : uint256(0);
+    }
+
+    bool isInBestChain(int height, const uint256 &hash)
+    {
+        const CBlockIndex *pindex = blockChain.getBestIndex();
+        while(pindex && pindex->nHeight > height)
+            pindex = pindex->pprev;
+        return pindex ? pindex->GetBlockHash() == hash : hash == 0;
+    }
+};
+
+WalletModel::WalletModel(Wallet *wallet, const BlockChain &blockChain, OptionsModel *optionsModel, QObject *parent) :
+    QObject(parent), wallet(wallet), walletInterface(new CoreWalletInterface(wallet)),
+    keyChain(DeterministicKeyChain::load(wallet)),
+    optionsModel(optionsModel), addressTableModel(0),
+    transactionTableModel(0), balances(new WalletBalancePriv(wallet, blockChain)),
     cachedBalance(0), cachedUnconfirmedBalance(0), cachedNumTransactions(0),
     cachedEncryptionStatus(Unencrypted)
 {
+    Summary initial;
+    CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        balances->totals.refresh();
+
+        initial.balance = balances->totals.getConfirmed();
+        initial.unconfirmedBalance = balances->totals.getUnconfirmed();
+        initial.immatureBalance = balances->totals.getImmature();
+        initial.numTransactions = wallet->mapWallet.size();
+        initial.bestHeight = balances->totals.getBestHeight();
+        initial.keyPoolSize = wallet->setKeyPool.size();
+    }
+    initial.encryptionStatus = queryEncryptionStatus();
+    publishSummary(initial);
+
     // Until signal notifications is built into the bitcoin core,
     //  simply update everything after polling using a timer.
     QTimer *timer = new QTimer(this);
     connect(timer, SIGNAL(timeout()), this, SLOT(update()));
     timer->start(MODEL_UPDATE_DELAY);
 
-    addressTableModel = new AddressTableModel(wallet, this);
-    transactionTableModel = new TransactionTableModel(wallet, this);
+    // The address and transaction table models are created on first use
+}
+
+WalletModel::~WalletModel()
+{
+    delete balances;
+    delete keyChain;
+    // The table models are children of this object and go after the interface they use
+    delete addressTableModel;
+    delete transactionTableModel;
+    delete walletInterface;
+}
+
+boost::shared_ptr<const WalletModel::Summary> WalletModel::getSummary() const
+{
+    return boost::atomic_load(&summary);
+}
+
+void WalletModel::publishSummary(const Summary &newSummary)
+{
+    boost::shared_ptr<const Summary> published(new Summary(newSummary));
+    boost::atomic_store(&summary, published);
 }
 
 qint64 WalletModel::getBalance() const
 {
-    return wallet->GetBalance();
+    return getSummary()->balance;
 }
 
 qint64 WalletModel::getUnconfirmedBalance() const
 {
-    return wallet->GetBalance(false);
+    return getSummary()->unconfirmedBalance;
+}
+
+qint64 WalletModel::getImmatureBalance() const
+{
+    return getSummary()->immatureBalance;
 }
 
 int WalletModel::getNumTransactions() const
 {
-    int numTransactions = 0;
-    CRITICAL_BLOCK(wallet->cs_wallet)
-    {
-        numTransactions = wallet->mapWallet.size();
-    }
-    return numTransactions;
+    return getSummary()->numTransactions;
 }
 
 void WalletModel::update()
 {
-    qint64 newBalance = getBalance();
-    qint64 newUnconfirmedBalance = getUnconfirmedBalance();
-    int newNumTransactions = getNumTransactions();
-    EncryptionStatus newEncryptionStatus = getEncryptionStatus();
+    QList<uint256> updated;
+    Summary newSummary = *getSummary();
 
-    if(cachedBalance != newBalance || cachedUnconfirmedBalance != newUnconfirmedBalance)
-        emit balanceChanged(newBalance, newUnconfirmedBalance);
+    // Collect the transactions that changed since the last tick, and fold them
+    // into the running totals. If the core is busy with the wallet, skip this tick
+    // and keep the previous summary.
+    TRY_CRITICAL_BLOCK(wallet->cs_wallet)
+    {
+        BOOST_FOREACH(uint256 hash, wallet->vWalletUpdated)
+        {
+            updated.append(hash);
+        }
+        wallet->vWalletUpdated.clear();
+
+        balances->totals.update(updated);
+
+        newSummary.balance = balances->totals.getConfirmed();
+        newSummary.unconfirmedBalance = balances->totals.getUnconfirmed();
+        newSummary.immatureBalance = balances->totals.getImmature();
+        newSummary.numTransactions = wallet->mapWallet.size();
+        newSummary.bestHeight = balances->totals.getBestHeight();
+        newSummary.keyPoolSize = wallet->setKeyPool.size();
+    }
+    newSummary.encryptionStatus = queryEncryptionStatus();
+    publishSummary(newSummary);
+
+    // A payment to a key of the window, e.g. to an address handed out by a restored copy of the
+    // wallet, moves the window past it
+    if(keyChain && !updated.empty())
+        keyChain->advancePastUsed(updated);
 
-    if(cachedNumTransactions != newNumTransactions)
-        emit numTransactionsChanged(newNumTransactions);
+    if(transactionTableModel && !updated.empty())
+        transactionTableModel->updateTransactions(updated);
 
-    if(cachedEncryptionStatus != newEncryptionStatus)
-        emit encryptionStatusChanged(newEncryptionStatus);
+    if(cachedBalance != newSummary.balance || cachedUnconfirmedBalance != newSummary.unconfirmedBalance)
+        emit balanceChanged(newSummary.balance, newSummary.unconfirmedBalance);
 
-    cachedBalance = newBalance;
-    cachedUnconfirmedBalance = newUnconfirmedBalance;
-    cachedNumTransactions = newNumTransactions;
+    if(cachedNumTransactions != newSummary.numTransactions)
+        emit numTransactionsChanged(newSummary.numTransactions);
 
-    addressTableModel->update();
+    if(cachedEncryptionStatus != newSummary.encryptionStatus)
+        emit encryptionStatusChanged(newSummary.encryptionStatus);
+
+    cachedBalance = newSummary.balance;
+    cachedUnconfirmedBalance = newSummary.unconfirmedBalance;
+    cachedNumTransactions = newSummary.numTransactions;
+    cachedEncryptionStatus = newSummary.encryptionStatus;
+
+    if(addressTableModel)
+        addressTableModel->update();
 }
 
 bool WalletModel::validateAddress(const QString &address)
 {
+    // Reject malformed input without the big number decode of the core
+    if(AddressChecker::check(address) != AddressChecker::Valid)
+        return false;
     ChainAddress addressParsed = wallet->chain().getAddress(address.toStdString());
     return addressParsed.isValid();
 }
@@ -107,12 +273,15 @@ WalletModel::SendCoinsReturn WalletModel::sendCoins(const QList<SendCoinsRecipie
         return DuplicateAddress;
     }
 
-    if(total > getBalance())
+    // The cached balance is good enough to reject obviously too large amounts up front
+    qint64 nBalance = getBalance();
+
+    if(total > nBalance)
     {
         return AmountExceedsBalance;
     }
 
-    if((total + wallet->nTransactionFee) > getBalance())
+    if((total + wallet->nTransactionFee) > nBalance)
     {
         return SendCoinsReturn(AmountWithFeeExceedsBalance, wallet->nTransactionFee);
     }
@@ -136,6 +305,7 @@ WalletModel::SendCoinsReturn WalletModel::sendCoins(const QList<SendCoinsRecipie
 
         if(!fCreated)
         {
+            // The balance may have changed since the checks above, compare with the live one
             if((total + nFeeRequired) > wallet->GetBalance())
             {
                 return SendCoinsReturn(AmountWithFeeExceedsBalance, nFeeRequired);
@@ -157,19 +327,33 @@ WalletModel::SendCoinsReturn WalletModel::sendCoins(const QList<SendCoinsRecipie
     foreach(const SendCoinsRecipient &rcp, recipients)
     {
         std::string strAddress = rcp.address.toStdString();
+        bool added = false;
         CRITICAL_BLOCK(wallet->cs_wallet)
         {
             if (!wallet->mapAddressBook.count(strAddress))
+            {
                 wallet->SetAddressBookName(strAddress, rcp.label.toStdString());
+                added = true;
+            }
         }
+        // Update our model of the address table, only the new row
+        if(added && addressTableModel)
+            addressTableModel->updateEntry(rcp.address, rcp.label, false);
     }
 
-    // Update our model of the address table
-    addressTableModel->updateList();
-
     return SendCoinsReturn(OK, 0, hex);
 }
 
+void WalletModel::addMemoryUsage(MemoryUsage &usage, const QString &walletName)
+{
+    MemoryAccounting::addWallet(usage, wallet, walletName);
+
+    if(transactionTableModel)
+        transactionTableModel->addMemoryUsage(usage, walletName);
+    if(addressTableModel)
+        addressTableModel->addMemoryUsage(usage, walletName);
+}
+
 OptionsModel *WalletModel::getOptionsModel()
 {
     return optionsModel;
@@ -177,15 +361,27 @@ OptionsModel *WalletModel::getOptionsModel()
 
 AddressTableModel *WalletModel::getAddressTableModel()
 {
+    if(!addressTableModel)
+        addressTableModel = new AddressTableModel(walletInterface, this);
     return addressTableModel;
 }
 
 TransactionTableModel *WalletModel::getTransactionTableModel()
 {
+    if(!transactionTableModel)
+    {
+        transactionTableModel = new TransactionTableModel(walletInterface, this);
+        emit transactionTableModelCreated(transactionTableModel);
+    }
     return transactionTableModel;
 }
 
 WalletModel::EncryptionStatus WalletModel::getEncryptionStatus() const
+{
+    return getSummary()->encryptionStatus;
+}
+
+WalletModel::EncryptionStatus WalletModel::queryEncryptionStatus() const
 {
     if(!wallet->IsCrypted())
     {
@@ -201,12 +397,28 @@ WalletModel::EncryptionStatus WalletModel::getEncryptionStatus() const
     }
 }
 
+void WalletModel::updateEncryptionStatus()
+{
+    Summary newSummary = *getSummary();
+    newSummary.encryptionStatus = queryEncryptionStatus();
+    publishSummary(newSummary);
+
+    if(cachedEncryptionStatus != newSummary.encryptionStatus)
+        emit encryptionStatusChanged(newSummary.encryptionStatus);
+    cachedEncryptionStatus = newSummary.encryptionStatus;
+}
+
 bool WalletModel::setWalletEncrypted(bool encrypted, const SecureString &passphrase)
 {
     if(encrypted)
     {
         // Encrypt
-        return wallet->EncryptWallet(passphrase);
+        bool retval = wallet->EncryptWallet(passphrase);
+        // The seed would give away every key derived from it, so new keys come from the pool from now on
+        if(retval)
+            DeterministicKeyChain::remove(wallet);
+        updateEncryptionStatus();
+        return retval;
     }
     else
     {
@@ -217,16 +429,19 @@ bool WalletModel::setWalletEncrypted(bool encrypted, const SecureString &passphr
 
 bool WalletModel::setWalletLocked(bool locked, const SecureString &passPhrase)
 {
+    bool retval;
     if(locked)
     {
         // Lock
-        return wallet->Lock();
+        retval = wallet->Lock();
     }
     else
     {
         // Unlock
-        return wallet->Unlock(passPhrase);
+        retval = wallet->Unlock(passPhrase);
     }
+    updateEncryptionStatus();
+    return retval;
 }
 
 bool WalletModel::changePassphrase(const SecureString &oldPass, const SecureString &newPass)
@@ -237,6 +452,7 @@ bool WalletModel::changePassphrase(const SecureString &oldPass, const SecureStri
         wallet->Lock(); // Make sure wallet is locked before attempting pass change
         retval = wallet->ChangeWalletPassphrase(oldPass, newPass);
     }
+    updateEncryptionStatus();
     return retval;
 }
 
@@ -245,17 +461,22 @@ bool WalletModel::backupWallet(const QString &filename)
     return BackupWallet(*wallet, filename.toLocal8Bit().data());
 }
 
+void WalletModel::setKeyPoolRefiller(KeyPoolRefiller *refiller)
+{
+    walletInterface->setKeyPoolRefiller(refiller);
+}
+
 // WalletModel::UnlockContext implementation
 WalletModel::UnlockContext WalletModel::requestUnlock()
 {
-    bool was_locked = getEncryptionStatus() == Locked;
+    bool was_locked = queryEncryptionStatus() == Locked;
     if(was_locked)
     {
         // Request UI to unlock wallet
         emit requireUnlock();
     }
     // If wallet is still locked, unlock was failed or cancelled, mark context as invalid
-    bool valid = getEncryptionStatus() != Locked;
+    bool valid = queryEncryptionStatus() != Locked;
 
     return UnlockContext(this, valid, was_locked);
 }
@@ -3,12 +3,21 @@
 
 #include <QObject>
 
+#include "memoryusage.h"
+
 #include <coin/util.h>
 
+#include <boost/shared_ptr.hpp>
+
 class OptionsModel;
 class AddressTableModel;
 class TransactionTableModel;
+class WalletBalancePriv;
 class Wallet;
+class CoreWalletInterface;
+class KeyPoolRefiller;
+class DeterministicKeyChain;
+class BlockChain;
 
 struct SendCoinsRecipient
 {
@@ -22,7 +31,8 @@ class WalletModel : public QObject
 {
     Q_OBJECT
 public:
-    explicit WalletModel(Wallet *wallet, OptionsModel *optionsModel, QObject *parent = 0);
+    explicit WalletModel(Wallet *wallet, const BlockChain &blockChain, OptionsModel *optionsModel, QObject *parent = 0);
+    ~WalletModel();
 
     enum StatusCode // Returned by sendCoins
     {
@@ -45,12 +55,39 @@ public:
         Unlocked      // wallet->IsCrypted() && !wallet->IsLocked()
     };
 
+    /** Immutable summary of the wallet state. A new instance is published after every
+        update, so a snapshot can be read from any thread without taking the wallet lock.
+    */
+    struct Summary
+    {
+        Summary():
+            balance(0), unconfirmedBalance(0), immatureBalance(0), numTransactions(0),
+            encryptionStatus(Unencrypted), bestHeight(-1), keyPoolSize(0) {}
+        qint64 balance;
+        qint64 unconfirmedBalance;
+        qint64 immatureBalance;
+        int numTransactions;
+        EncryptionStatus encryptionStatus;
+        int bestHeight;
+        int keyPoolSize;
+    };
+
     OptionsModel *getOptionsModel();
+    // The table models are created on first use
     AddressTableModel *getAddressTableModel();
     TransactionTableModel *getTransactionTableModel();
+    // Transaction table model if a page has created it already, 0 otherwise
+    TransactionTableModel *getExistingTransactionTableModel() const { return transactionTableModel; }
+
+    // Add the estimated memory used by the wallet transactions and by the table models, if created
+    void addMemoryUsage(MemoryUsage &usage, const QString &walletName);
+
+    // Most recently published summary, never blocks on the wallet
+    boost::shared_ptr<const Summary> getSummary() const;
 
     qint64 getBalance() const;
     qint64 getUnconfirmedBalance() const;
+    qint64 getImmatureBalance() const;
     int getNumTransactions() const;
     EncryptionStatus getEncryptionStatus() const;
 
@@ -80,6 +117,9 @@ public:
     // Wallet backup
     bool backupWallet(const QString &filename);
 
+    // Refiller to wake when a new receiving address takes a key from the pool
+    void setKeyPoolRefiller(KeyPoolRefiller *refiller);
+
     // get a const handle to the wallet (not the optimal way to do this...)
     Wallet* getWallet() const { return wallet; }
 
@@ -108,6 +148,10 @@ public:
 
 private:
     Wallet *wallet;
+    // What the table models see of the wallet
+    CoreWalletInterface *walletInterface;
+    // Receiving keys derived from a seed, 0 if the wallet has none
+    DeterministicKeyChain *keyChain;
 
     // Wallet has an options model for wallet-specific options
     // (transaction fee, for example)
@@ -116,6 +160,18 @@ private:
     AddressTableModel *addressTableModel;
     TransactionTableModel *transactionTableModel;
 
+    // Running balance totals, updated from the transactions the wallet reports as changed
+    WalletBalancePriv *balances;
+
+    // Current summary, only accessed through boost::atomic_load/atomic_store
+    boost::shared_ptr<const Summary> summary;
+
+    void publishSummary(const Summary &newSummary);
+    // Query encryption status from the wallet itself, instead of from the summary
+    EncryptionStatus queryEncryptionStatus() const;
+    // Publish a changed encryption status right away, after locking or unlocking
+    void updateEncryptionStatus();
+
     // Cache some values to be able to detect changes
     qint64 cachedBalance;
     qint64 cachedUnconfirmedBalance;
@@ -132,6 +188,9 @@ signals:
     // Encryption status of wallet changed
     void encryptionStatusChanged(int status);
 
+    // Transaction table model was created on first use
+    void transactionTableModelCreated(TransactionTableModel *model);
+
     // Signal emitted when wallet needs to be unlocked
     // It is valid behaviour for listeners to keep the wallet locked after this signal;
     // this means that the unlocking failed or was cancelled.
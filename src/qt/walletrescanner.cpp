@@ -0,0 +1,248 @@
+#include "walletrescanner.h"
+#include "deterministickeychain.h"
+
+#include <coinChain/Node.h>
+#include <coinWallet/Wallet.h>
+#include <coinWallet/WalletDB.h>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <vector>
+#include <set>
+
+/* Number of blocks handed to a worker at a time. Bounds the number of blocks
+   held in memory to numThreads * RESCAN_BATCH_SIZE.
+ */
+static const int RESCAN_BATCH_SIZE = 64;
+
+/* Block timestamps are only required to be within two hours of the network time,
+   so start looking for transactions this much before the requested time.
+ */
+static const qint64 RESCAN_TIME_WINDOW = 2 * 60 * 60;
+
+// Block read by the scanner, with the key hashes its transactions pay to
+struct ScannedBlock
+{
+    const CBlockIndex *pindex;
+    Block block;
+    // Transaction index and key hash of every output that pays to a key
+    std::vector<std::pair<int, PubKeyHash> > payees;
+    // Transaction index of every output to a script hash or another script, left for the wallet to match
+    std::set<int> scripts;
+};
+
+// Worker: extract the key hashes that the outputs of a range of blocks pay to. Does not touch the
+// wallet, the scanner thread matches the hashes against the wallet keys under its lock.
+static void extractPayees(std::vector<ScannedBlock> *blocks, int begin, int end)
+{
+    for(int idx = begin; idx < end; ++idx)
+    {
+        ScannedBlock &scanned = blocks->at(idx);
+        const Transactions &txes = scanned.block.getTransactions();
+        for(int tx_idx = 0; tx_idx < (int)txes.size(); ++tx_idx)
+        {
+            BOOST_FOREACH(const Output& txout, txes[tx_idx].getOutputs())
+            {
+                PubKeyHash pubKeyHash;
+                ScriptHash scriptHash;
+                if(ExtractAddress(txout.script(), pubKeyHash, scriptHash) && pubKeyHash != 0)
+                    scanned.payees.push_back(std::make_pair(tx_idx, pubKeyHash));
+                else
+                    scanned.scripts.insert(tx_idx);
+            }
+        }
+    }
+}
+
+WalletRescanner::WalletRescanner(const Node &node, Wallet *wallet, int startHeight, QObject *parent):
+    QThread(parent), node(node), wallet(wallet), startHeight(startHeight),
+    numThreads(boost::thread::hardware_concurrency()), fPaused(false), fCancelled(false)
+{
+    if(numThreads < 1)
+        numThreads = 1;
+}
+
+WalletRescanner::~WalletRescanner()
+{
+    cancel();
+    wait();
+}
+
+void WalletRescanner::setNumThreads(int threads)
+{
+    numThreads = threads < 1 ? 1 : threads;
+}
+
+bool WalletRescanner::isPaused() const
+{
+    QMutexLocker lock(&mutex);
+    return fPaused;
+}
+
+void WalletRescanner::pause()
+{
+    QMutexLocker lock(&mutex);
+    fPaused = true;
+}
+
+void WalletRescanner::resume()
+{
+    QMutexLocker lock(&mutex);
+    fPaused = false;
+    resumed.wakeAll();
+}
+
+void WalletRescanner::cancel()
+{
+    QMutexLocker lock(&mutex);
+    fCancelled = true;
+    fPaused = false;
+    resumed.wakeAll();
+}
+
+qint64 WalletRescanner::getBirthday(const Wallet *wallet)
+{
+    int64 nBirthday = 0;
+    CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+    walletdb.ReadSetting("nWalletBirthday", nBirthday);
+    return nBirthday;
+}
+
+void WalletRescanner::setBirthday(Wallet *wallet, qint64 time)
+{
+    CWalletDB walletdb(wallet->getDateDir(), wallet->strWalletFile);
+    walletdb.WriteSetting("nWalletBirthday", (int64)time);
+}
+
+int WalletRescanner::heightForTime(const Node &node, qint64 time)
+{
+    const CBlockIndex *pindex = node.blockChain().getBestIndex();
+    if(!pindex)
+        return 0;
+    // Walk back to the last block mined before the window, the block after it is the first one to scan
+    while(pindex->pprev && pindex->pprev->GetBlockTime() >= time - RESCAN_TIME_WINDOW)
+        pindex = pindex->pprev;
+    return pindex->nHeight;
+}
+
+bool WalletRescanner::checkpoint()
+{
+    QMutexLocker lock(&mutex);
+    while(fPaused && !fCancelled)
+        resumed.wait(&mutex);
+    return !fCancelled;
+}
+
+void WalletRescanner::run()
+{
+    const BlockChain &blockChain = node.blockChain();
+
+    if(startHeight < 0)
+    {
+        qint64 nBirthday = getBirthday(wallet);
+        startHeight = nBirthday ? heightForTime(node, nBirthday) : 0;
+    }
+
+    // Collect the blocks to scan, by walking back from the current best block
+    std::vector<const CBlockIndex*> chain;
+    for(const CBlockIndex *pindex = blockChain.getBestIndex(); pindex && pindex->nHeight >= startHeight; pindex = pindex->pprev)
+        chain.push_back(pindex);
+    std::reverse(chain.begin(), chain.end());
+
+    int tipHeight = chain.empty() ? startHeight : chain.back()->nHeight;
+    int found = 0;
+    qint64 nStart = QDateTime::currentMSecsSinceEpoch();
+
+    boost::scoped_ptr<DeterministicKeyChain> keyChain(DeterministicKeyChain::load(wallet));
+
+    int next = 0;
+    while(next < (int)chain.size())
+    {
+        // Transactions added from this batch
+        QList<uint256> added;
+        if(!checkpoint())
+        {
+            emit scanFinished(found, true);
+            return;
+        }
+
+        // Read the next batch of blocks. Nothing says that BlockChain can be read from several threads
+        // at once, so the reads are done here, one at a time.
+        int batchEnd = std::min((int)chain.size(), next + numThreads * RESCAN_BATCH_SIZE);
+        std::vector<ScannedBlock> batch(batchEnd - next);
+        for(int idx = 0; idx < (int)batch.size(); ++idx)
+        {
+            batch[idx].pindex = chain[next + idx];
+            blockChain.getBlock(batch[idx].pindex->GetBlockHash(), batch[idx].block);
+        }
+
+        // Extract the payees in parallel
+        boost::thread_group workers;
+        for(int begin = 0; begin < (int)batch.size(); begin += RESCAN_BATCH_SIZE)
+            workers.create_thread(boost::bind(&extractPayees, &batch, begin, std::min((int)batch.size(), begin + RESCAN_BATCH_SIZE)));
+        workers.join_all();
+
+        // Merge in height order. Credits and spends are matched here rather than in the workers,
+        // under the wallet lock, and see the keys and transactions added earlier in this batch.
+        // Transactions with outputs to other scripts, such as script hashes, are left to the
+        // wallet's own IsMine test in AddToWalletIfInvolvingMe.
+        BOOST_FOREACH(const ScannedBlock &scanned, batch)
+        {
+            std::set<int> credits = scanned.scripts;
+            CRITICAL_BLOCK(wallet->cs_wallet)
+            {
+                for(size_t i = 0; i < scanned.payees.size(); ++i)
+                {
+                    if(!credits.count(scanned.payees[i].first) && wallet->haveKey(scanned.payees[i].second))
+                        credits.insert(scanned.payees[i].first);
+                }
+            }
+            const Transactions &txes = scanned.block.getTransactions();
+            for(int tx_idx = 0; tx_idx < (int)txes.size(); ++tx_idx)
+            {
+                const Transaction &tx = txes[tx_idx];
+                bool fInvolved = credits.count(tx_idx);
+                if(!fInvolved)
+                {
+                    CRITICAL_BLOCK(wallet->cs_wallet)
+                    {
+                        BOOST_FOREACH(const Input& txin, tx.getInputs())
+                        {
+                            if(wallet->mapWallet.count(txin.prevout().hash))
+                            {
+                                fInvolved = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if(fInvolved && wallet->AddToWalletIfInvolvingMe(tx, &scanned.block, true))
+                {
+                    ++found;
+                    added.append(tx.getHash());
+                }
+            }
+        }
+        next = batchEnd;
+
+        // Payments to keys derived from the seed move the window of stored keys along, so that
+        // later blocks are matched against the keys past them
+        if(keyChain && !added.isEmpty())
+            keyChain->advancePastUsed(added);
+
+        // Estimate remaining time from the average rate so far
+        int scanned = next;
+        qint64 nElapsed = QDateTime::currentMSecsSinceEpoch() - nStart;
+        int secsRemaining = -1;
+        if(scanned > 0 && nElapsed > 0)
+            secsRemaining = (int)((nElapsed * (qint64)(chain.size() - scanned)) / scanned / 1000);
+        emit progress(chain[next - 1]->nHeight, tipHeight, secsRemaining);
+    }
+    emit scanFinished(found, false);
+}
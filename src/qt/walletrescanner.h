@@ -0,0 +1,70 @@
+#ifndef WALLETRESCANNER_H
+#define WALLETRESCANNER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+class Node;
+class Wallet;
+
+/** Rescans the block chain for wallet transactions in the background.
+
+    Blocks are read on the scanner thread in batches, and the key hashes their outputs pay to are
+    extracted in parallel, a range of heights per worker. The matching transactions are then added to the
+    wallet on the scanner thread in height order, so that spends are always seen after the outputs they
+    spend.
+ */
+class WalletRescanner : public QThread
+{
+    Q_OBJECT
+public:
+    /** Scan from block height startHeight up to the best block at the time the scan starts.
+        A negative startHeight scans from the wallet birthday, or from the genesis block if that is not known.
+     */
+    explicit WalletRescanner(const Node &node, Wallet *wallet, int startHeight = -1, QObject *parent = 0);
+    /** Cancels a running scan, and waits for it to finish. */
+    ~WalletRescanner();
+
+    /** Set number of worker threads, defaults to the number of cores. */
+    void setNumThreads(int threads);
+
+    bool isPaused() const;
+
+    /** Earliest key creation time of the wallet as a unix timestamp, or 0 if unknown. */
+    static qint64 getBirthday(const Wallet *wallet);
+    /** Record the wallet birthday, call this when a wallet file is created. */
+    static void setBirthday(Wallet *wallet, qint64 time);
+    /** Height of the first block in the best chain that can contain transactions made at or after time. */
+    static int heightForTime(const Node &node, qint64 time);
+
+public slots:
+    void pause();
+    void resume();
+    void cancel();
+
+signals:
+    /** Blocks up to height have been scanned, out of tipHeight. secsRemaining is -1 while unknown. */
+    void progress(int height, int tipHeight, int secsRemaining);
+    /** Scan ended, found is the number of wallet transactions added or updated. */
+    void scanFinished(int found, bool cancelled);
+
+protected:
+    void run();
+
+private:
+    const Node &node;
+    Wallet *wallet;
+    int startHeight;
+    int numThreads;
+
+    mutable QMutex mutex;
+    QWaitCondition resumed;
+    bool fPaused;
+    bool fCancelled;
+
+    /** Block while paused, return false when the scan should stop. */
+    bool checkpoint();
+};
+
+#endif // WALLETRESCANNER_H